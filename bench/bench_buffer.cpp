@@ -0,0 +1,104 @@
+// bench/bench_buffer.cpp
+//
+// Buffer (array of 20-byte Cells) vs PlanarBuffer (codepoint / width /
+// style planes) on a 240x60 frame:
+//   - fill:       fill_rect with a whole cell
+//   - fill style: restyle a region (AoS rewrites each cell's style field)
+//   - blit:       copy one buffer into another
+//   - diff:       diff_spans on every row, one change per row
+
+#include "bench_util.h"
+
+#include "glyph/core/buffer.h"
+#include "glyph/core/diff.h"
+#include "glyph/core/planar_buffer.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace glyph::core;
+
+namespace {
+
+  constexpr Size kSize{240, 60};
+  constexpr Rect kPane{20, 5, 200, 50};
+
+  void compare(const char *label, double aos, double planar) {
+    std::printf("%-40s %12.2fx\n", label, aos / planar);
+  }
+
+} // namespace
+
+int main() {
+  Buffer       aos{kSize};
+  Buffer       aos2{kSize};
+  PlanarBuffer planar{kSize};
+  PlanarBuffer planar2{kSize};
+  const Cell   dot   = Cell::from_char(U'.', Style::with_fg(0x808080));
+  const Style  theme = Style::with_bg(0x202040);
+
+  std::puts("-- fill");
+  double a = glyph::bench::run("aos/fill_rect", [&] {
+    aos.fill_rect(kPane, dot);
+    glyph::bench::do_not_optimize(aos);
+  });
+  double p = glyph::bench::run("planar/fill_rect", [&] {
+    planar.fill_rect(kPane, dot);
+    glyph::bench::do_not_optimize(planar);
+  });
+  compare("speedup", a, p);
+
+  std::puts("-- fill style");
+  a = glyph::bench::run("aos/restyle", [&] {
+    auto v = aos.view().subview(kPane);
+    for (coord_t y = 0; y < v.size.h; ++y) {
+      for (coord_t x = 0; x < v.size.w; ++x) {
+        v.at(x, y).style = theme;
+      }
+    }
+    glyph::bench::do_not_optimize(aos);
+  });
+  p = glyph::bench::run("planar/fill_style", [&] {
+    planar.fill_style(kPane, theme);
+    glyph::bench::do_not_optimize(planar);
+  });
+  compare("speedup", a, p);
+
+  std::puts("-- blit");
+  a = glyph::bench::run("aos/blit", [&] {
+    aos2.blit(aos.const_view(), Point{0, 0});
+    glyph::bench::do_not_optimize(aos2);
+  });
+  p = glyph::bench::run("planar/blit", [&] {
+    planar2.blit(planar, Point{0, 0});
+    glyph::bench::do_not_optimize(planar2);
+  });
+  compare("speedup", a, p);
+
+  std::puts("-- diff (one change per row)");
+  aos2.blit(aos.const_view(), Point{0, 0});
+  planar2.blit(planar, Point{0, 0});
+  for (coord_t y = 0; y < kSize.h; ++y) {
+    const Point at{coord_t((y * 37) % kSize.w), y};
+    aos2.view().at(at.x, at.y) = Cell::from_char(U'#');
+    planar2.set(at, Cell::from_char(U'#'));
+  }
+  std::vector<coord_t> lines;
+  for (coord_t y = 0; y < kSize.h; ++y)
+    lines.push_back(y);
+  std::vector<DiffSpan> spans;
+  spans.reserve(std::size_t(kSize.h) * 4);
+
+  a = glyph::bench::run("aos/diff_spans", [&] {
+    spans.clear();
+    diff_spans(aos.const_view(), aos2.const_view(), lines, spans);
+    glyph::bench::do_not_optimize(spans.size());
+  });
+  p = glyph::bench::run("planar/diff_spans", [&] {
+    spans.clear();
+    diff_spans(planar, planar2, lines, spans);
+    glyph::bench::do_not_optimize(spans.size());
+  });
+  compare("speedup", a, p);
+  return 0;
+}
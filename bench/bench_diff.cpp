@@ -0,0 +1,124 @@
+// bench/bench_diff.cpp
+//
+// Row diff: per-cell compare behind a hash filter (the former path) vs the
+// vectorized row compare now used by diff_spans/rows_equal, which is also
+// how the renderer diffs frames against its shadow.
+//
+// Scenarios on a 240x60 frame:
+//   - idle:   every row dirty, nothing changed (hash filter's best case)
+//   - sparse: every row dirty, one cell changed per row
+//   - dense:  every row dirty, every 8th cell changed
+//   - styled: as sparse, with the style changing every 4 cells
+
+#include "bench_util.h"
+
+#include "glyph/core/buffer.h"
+#include "glyph/core/diff.h"
+#include "glyph/core/row_compare.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace glyph::core;
+
+namespace {
+
+  constexpr Size kSize{240, 60};
+
+  // The pre-SIMD path: hash both rows, then walk changed rows cell by cell.
+  void diff_hashed_scalar(ConstBufferView prev, ConstBufferView next,
+                          const std::vector<coord_t> &lines,
+                          std::vector<DiffSpan>      &spans) {
+    for (coord_t y : lines) {
+      if (hash_line(prev, y) == hash_line(next, y))
+        continue;
+      coord_t x = 0;
+      while (x < next.size.w) {
+        if (prev.at(x, y) == next.at(x, y)) {
+          ++x;
+          continue;
+        }
+        const coord_t x0 = x;
+        while (x < next.size.w && prev.at(x, y) != next.at(x, y))
+          ++x;
+        spans.push_back(DiffSpan{y, x0, x});
+      }
+    }
+  }
+
+  void scenario(const char *label, int every, int style_run = 0) {
+    Buffer prev{kSize};
+    Buffer next{kSize};
+    prev.view().clear(Cell::from_char(U'.'));
+    next.view().clear(Cell::from_char(U'.'));
+    if (style_run > 0) {
+      for (coord_t y = 0; y < kSize.h; ++y) {
+        for (coord_t x = 0; x < kSize.w; ++x) {
+          const auto s =
+              Style::with_fg(std::uint32_t(0x102030 * (x / style_run % 7)));
+          prev.view().at(x, y) = Cell::from_char(U'.', s);
+          next.view().at(x, y) = Cell::from_char(U'.', s);
+        }
+      }
+    }
+    if (every > 0) {
+      for (coord_t y = 0; y < kSize.h; ++y) {
+        for (coord_t x = coord_t(y % every); x < kSize.w;
+             x = coord_t(x + every)) {
+          next.view().at(x, y) = Cell::from_char(U'#');
+        }
+      }
+    }
+
+    std::vector<coord_t> lines;
+    for (coord_t y = 0; y < kSize.h; ++y)
+      lines.push_back(y);
+    std::vector<DiffSpan> spans;
+    spans.reserve(std::size_t(kSize.w) * std::size_t(kSize.h));
+
+    std::printf("-- %s\n", label);
+    char name[64];
+    std::snprintf(name, sizeof name, "%s/hash+scalar", label);
+    const double base = glyph::bench::run(name, [&] {
+      spans.clear();
+      diff_hashed_scalar(prev.const_view(), next.const_view(), lines, spans);
+      glyph::bench::do_not_optimize(spans.size());
+    });
+
+    std::snprintf(name, sizeof name, "%s/row compare (%s)", label,
+                  to_string(row_compare_isa()));
+    const double simd = glyph::bench::run(name, [&] {
+      spans.clear();
+      diff_spans(prev.const_view(), next.const_view(), lines, spans);
+      glyph::bench::do_not_optimize(spans.size());
+    });
+    std::printf("%-40s %12.2fx\n", "speedup", base / simd);
+  }
+
+  // Raw kernel throughput on equal rows.
+  void kernels() {
+    std::vector<Cell> a(std::size_t(kSize.w) * std::size_t(kSize.h),
+                        Cell::from_char(U'.'));
+    std::vector<Cell> b = a;
+    std::printf("-- first_mismatch over %zu equal cells\n", a.size());
+    for (auto isa : {RowCompareIsa::Scalar, RowCompareIsa::Sse2,
+                     RowCompareIsa::Avx2}) {
+      if (!row_compare_supported(isa))
+        continue;
+      glyph::bench::run(to_string(isa), [&] {
+        glyph::bench::do_not_optimize(
+            first_mismatch(isa, a.data(), b.data(), a.size()));
+      });
+    }
+  }
+
+} // namespace
+
+int main() {
+  scenario("idle", 0);
+  scenario("sparse", kSize.w);
+  scenario("dense", 8);
+  scenario("styled", kSize.w, 4);
+  kernels();
+  return 0;
+}
@@ -0,0 +1,64 @@
+// bench/bench_util.h
+//
+// Minimal timing harness for the microbenchmarks (no external framework).
+//
+// Each benchmark body runs in batches until a time budget is spent; the
+// best batch is reported per iteration, which is stable enough to compare
+// two code paths on one machine.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace glyph::bench {
+
+  // Keep `v` alive so the optimizer cannot drop the work producing it.
+  template <class T> inline void do_not_optimize(const T &v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&v) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &v;
+#endif
+  }
+
+  // Run `body` repeatedly and print the best ns/iteration under `name`.
+  // Returns that figure so callers can print ratios.
+  template <class Body>
+  double run(const char *name, Body &&body,
+             std::chrono::milliseconds budget = std::chrono::milliseconds{300}) {
+    using clock = std::chrono::steady_clock;
+
+    // Grow the batch until one takes ~1ms, so timer overhead is noise.
+    std::uint64_t batch = 1;
+    for (;;) {
+      const auto t0 = clock::now();
+      for (std::uint64_t i = 0; i < batch; ++i)
+        body();
+      if (clock::now() - t0 >= std::chrono::milliseconds{1} ||
+          batch >= (1u << 24))
+        break;
+      batch *= 2;
+    }
+
+    double     best = 1e300;
+    const auto end  = clock::now() + budget;
+    while (clock::now() < end) {
+      const auto t0 = clock::now();
+      for (std::uint64_t i = 0; i < batch; ++i)
+        body();
+      const double ns =
+          double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     clock::now() - t0)
+                     .count()) /
+          double(batch);
+      if (ns < best)
+        best = ns;
+    }
+    std::printf("%-40s %12.1f ns/iter\n", name, best);
+    return best;
+  }
+
+} // namespace glyph::bench
@@ -0,0 +1,103 @@
+// bench/bench_width.cpp
+//
+// core::cell_width throughput, in codepoints per second: the two-stage
+// table lookup vs the range-comparison chain it replaced.
+//
+// Inputs (64 Ki codepoints each):
+//   - ascii: printable ASCII
+//   - cjk:   CJK unified ideographs and Hangul syllables
+//   - mixed: runs of ASCII, Latin-1, Cyrillic, CJK, emoji and combining
+//            marks
+
+#include "bench_util.h"
+
+#include "glyph/core/text.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace glyph::core;
+
+namespace {
+
+  constexpr std::size_t kCount = 1u << 16;
+
+  // The former rule: a chain of range comparisons.
+  std::uint8_t range_chain_width(char32_t c) noexcept {
+    if (c == U'\0')
+      return 0;
+    if (c < 0x20 || c == 0x7F)
+      return 0;
+    if ((c >= 0x1100 && c <= 0x115F) || (c >= 0x2E80 && c <= 0xA4CF) ||
+        (c >= 0xAC00 && c <= 0xD7A3) || (c >= 0xF900 && c <= 0xFAFF) ||
+        (c >= 0xFE10 && c <= 0xFE19) || (c >= 0xFE30 && c <= 0xFE6F) ||
+        (c >= 0xFF00 && c <= 0xFF60) || (c >= 0xFFE0 && c <= 0xFFE6))
+      return 2;
+    if (c == 0x1F004 || c == 0x1F0CF || (c >= 0x1F1E6 && c <= 0x1F1FF) ||
+        (c >= 0x1F200 && c <= 0x1F2FF) || (c >= 0x1F300 && c <= 0x1FAFF))
+      return 2;
+    return 1;
+  }
+
+  // Deterministic xorshift, so every run measures the same text.
+  std::uint32_t next_rand(std::uint32_t &s) noexcept {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+  }
+
+  std::vector<char32_t> make_text(const char32_t (*pools)[2],
+                                  std::size_t npools) {
+    std::vector<char32_t> out(kCount);
+    std::uint32_t         seed = 0x9E3779B9u;
+    // Runs of 1..8 codepoints from one script, like words in real text.
+    for (std::size_t i = 0; i < out.size();) {
+      const auto &p    = pools[next_rand(seed) % npools];
+      const auto  span = std::uint32_t(p[1] - p[0] + 1);
+      for (std::uint32_t n = 1 + next_rand(seed) % 8; n && i < out.size();
+           --n) {
+        out[i++] = char32_t(p[0] + next_rand(seed) % span);
+      }
+    }
+    return out;
+  }
+
+  template <class Width>
+  double sum_widths(const char *name, const std::vector<char32_t> &text,
+                    Width width) {
+    return glyph::bench::run(name, [&] {
+      unsigned total = 0;
+      for (char32_t c : text)
+        total += width(c);
+      glyph::bench::do_not_optimize(total);
+    });
+  }
+
+  void scenario(const char *label, const std::vector<char32_t> &text) {
+    std::printf("-- %s\n", label);
+    const double table = sum_widths("table", text, [](char32_t c) {
+      return cell_width(c);
+    });
+    const double chain = sum_widths("range chain", text, range_chain_width);
+    const double n     = double(text.size());
+    std::printf("%-40s %12.1f Mcp/s\n", "table", n / table * 1e3);
+    std::printf("%-40s %12.1f Mcp/s\n", "range chain", n / chain * 1e3);
+  }
+
+} // namespace
+
+int main() {
+  const char32_t ascii[][2] = {{0x20, 0x7E}};
+  const char32_t cjk[][2]   = {{0x4E00, 0x9FFF}, {0xAC00, 0xD7A3}};
+  const char32_t mixed[][2] = {
+      {0x20, 0x7E},   {0x20, 0x7E},   {0x20, 0x7E},     {0xA0, 0xFF},
+      {0x400, 0x4FF}, {0x4E00, 0x9FFF}, {0x1F300, 0x1F64F}, {0x300, 0x36F},
+  };
+
+  scenario("ascii", make_text(ascii, std::size(ascii)));
+  scenario("cjk", make_text(cjk, std::size(cjk)));
+  scenario("mixed", make_text(mixed, std::size(mixed)));
+  return 0;
+}
@@ -6,17 +6,25 @@
 //   - Own or view a rectangular 2D grid of Cells
 //   - Provide safe read/write primitives
 //   - Provide clipping against bounds
+//   - Carry the ClusterPool that resolves grapheme-cluster cells
+//   - Cache per-row hashes, recomputed lazily after a row is written
 
 #pragma once
 
 #include "cell.h"
+#include "cluster.h"
 #include "geometry.h"
 #include "glyph/core/types.h"
+#include "row_hash.h"
 #include "types.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <vector>
 
 namespace glyph::core {
@@ -25,14 +33,16 @@ namespace glyph::core {
   // ConstBufferView: read-only, non-owning 2D view
   // ------------------------------------------------------------
   struct ConstBufferView final {
-    const Cell    *data = nullptr;
-    Size           size{};
-    std::ptrdiff_t stride = 0; // elements per row
+    const Cell        *data = nullptr;
+    Size               size{};
+    std::ptrdiff_t     stride   = 0;       // elements per row
+    const ClusterPool *clusters = nullptr; // resolves is_cluster() cells
 
     constexpr ConstBufferView() noexcept = default;
 
-    constexpr ConstBufferView(const Cell *d, Size s, std::ptrdiff_t st) noexcept
-        : data(d), size(s), stride(st) {
+    constexpr ConstBufferView(const Cell *d, Size s, std::ptrdiff_t st,
+                              const ClusterPool *cl = nullptr) noexcept
+        : data(d), size(s), stride(st), clusters(cl) {
     }
 
     [[nodiscard]] constexpr bool empty() const noexcept {
@@ -66,55 +76,193 @@ namespace glyph::core {
           data + offset,
           clipped.size,
           stride,
+          clusters,
       };
     }
   };
 
   // ------------------------------------------------------------
   // Dirty line tracking
+  //
+  // One bit per row (packed into 64-bit words) plus a count of set bits,
+  // so "did anything change" is a single compare and taking the set walks
+  // only the dirty rows. Each dirty row also keeps the column window
+  // [x0, x1) written since the last take, so a one-cell update costs one
+  // cell to diff rather than a row. Two more bit sets record rows written
+  // since their hash was last cached (see Buffer::row_hash) and since the
+  // buffer was last cleared (see Buffer::clear_written).
   // ------------------------------------------------------------
+
+  // Columns [x0, x1) of row y were written. Half-open, like DiffSpan.
+  struct DirtyRow final {
+    coord_t y  = 0;
+    coord_t x0 = 0;
+    coord_t x1 = 0;
+  };
+
   class DirtyLines final {
   public:
+    // Column bound meaning "to the end of the row".
+    static constexpr coord_t kWholeRow = std::numeric_limits<coord_t>::max();
+
+    // Track `h` rows, all of them dirty.
     void resize(coord_t h) {
-      flags_.assign(std::size_t(h), std::uint8_t(1));
+      h = std::max<coord_t>(h, 0);
+      extents_.assign(std::size_t(h), Extent{0, kWholeRow});
+      bits_.assign((std::size_t(h) + 63) / 64, ~std::uint64_t(0));
+      if (h % 64 != 0)
+        bits_.back() = (std::uint64_t(1) << (h % 64)) - 1;
+      count_   = std::size_t(h);
+      stale_   = bits_;
+      written_ = bits_;
+    }
+
+    [[nodiscard]] bool any() const noexcept {
+      return count_ != 0;
+    }
+
+    // Number of dirty rows.
+    [[nodiscard]] std::size_t count() const noexcept {
+      return count_;
     }
 
     void mark(coord_t y) noexcept {
-      if (y < 0 || y >= coord_t(flags_.size()))
+      mark(y, 0, kWholeRow);
+    }
+
+    // Mark columns [x0, x1) of row y.
+    void mark(coord_t y, coord_t x0, coord_t x1) noexcept {
+      if (y < 0 || y >= coord_t(extents_.size()) || x1 <= x0)
+        return;
+      auto      &word = bits_[std::size_t(y) >> 6];
+      const auto bit  = std::uint64_t(1) << (std::size_t(y) & 63);
+      auto      &e    = extents_[std::size_t(y)];
+      stale_[std::size_t(y) >> 6] |= bit;
+      written_[std::size_t(y) >> 6] |= bit;
+      if (!(word & bit)) {
+        word |= bit;
+        ++count_;
+        e = Extent{x0, x1};
         return;
-      flags_[std::size_t(y)] = 1;
+      }
+      e.x0 = std::min(e.x0, x0);
+      e.x1 = std::max(e.x1, x1);
     }
 
     void mark_range(coord_t y0, coord_t y1) noexcept {
-      if (flags_.empty())
-        return;
-      if (y0 < 0)
-        y0 = 0;
-      if (y1 > coord_t(flags_.size()))
-        y1 = coord_t(flags_.size());
+      mark_range(y0, y1, 0, kWholeRow);
+    }
+
+    // Mark columns [x0, x1) of rows [y0, y1).
+    void mark_range(coord_t y0, coord_t y1, coord_t x0, coord_t x1) noexcept {
+      y0 = std::max<coord_t>(y0, 0);
+      y1 = std::min(y1, coord_t(extents_.size()));
       for (coord_t y = y0; y < y1; ++y) {
-        flags_[std::size_t(y)] = 1;
+        mark(y, x0, x1);
       }
     }
 
+    // Clean rows' extents are stale but unread: only the bits reset.
     void clear() noexcept {
-      for (auto &f : flags_)
-        f = 0;
+      if (count_ == 0)
+        return;
+      std::fill(bits_.begin(), bits_.end(), std::uint64_t(0));
+      count_ = 0;
+    }
+
+    // Whether row y was marked since the last take_stale(y), clearing the
+    // flag. Independent of take()/clear(): consumers of the dirty rows and
+    // the owner of a cached row hash each see every write.
+    [[nodiscard]] bool take_stale(coord_t y) noexcept {
+      if (y < 0 || y >= coord_t(extents_.size()))
+        return false;
+      auto      &word = stale_[std::size_t(y) >> 6];
+      const auto bit  = std::uint64_t(1) << (std::size_t(y) & 63);
+      const bool was  = (word & bit) != 0;
+      word &= ~bit;
+      return was;
+    }
+
+    // Call f(y) for every row marked since the last forget_written(), then
+    // forget them, including any rows f marks itself.
+    template <class F> void take_written(F &&f) {
+      for (std::size_t w = 0; w < written_.size(); ++w) {
+        for (std::uint64_t word = written_[w]; word != 0; word &= word - 1) {
+          f(coord_t((w << 6) + std::size_t(std::countr_zero(word))));
+        }
+      }
+      forget_written();
     }
 
-    std::vector<coord_t> take() noexcept {
+    void forget_written() noexcept {
+      std::fill(written_.begin(), written_.end(), std::uint64_t(0));
+    }
+
+    // Union with another tracker. Trackers of different heights describe
+    // different layouts, so everything is marked.
+    void merge(const DirtyLines &other) noexcept {
+      if (other.extents_.size() != extents_.size()) {
+        mark_range(0, coord_t(extents_.size()));
+        return;
+      }
+      other.for_each_([&](std::size_t y) {
+        const auto &o = other.extents_[y];
+        mark(coord_t(y), o.x0, o.x1);
+      });
+    }
+
+    // Dirty row indices, then clear. Allocates; prefer take_into().
+    std::vector<coord_t> take() {
       std::vector<coord_t> out;
-      for (coord_t y = 0; y < coord_t(flags_.size()); ++y) {
-        if (flags_[std::size_t(y)]) {
-          out.push_back(y);
+      out.reserve(count_);
+      for_each_([&](std::size_t y) { out.push_back(coord_t(y)); });
+      clear();
+      return out;
+    }
+
+    // Replace the contents of `out` with the dirty rows in order, windows
+    // clipped to [0, width), and clear. Returns a view of `out`. Reusing
+    // `out` across frames keeps this allocation-free; with nothing dirty
+    // it returns after one branch.
+    std::span<const DirtyRow> take_into(std::vector<DirtyRow> &out,
+                                        coord_t                width) {
+      out.clear();
+      if (count_ == 0)
+        return {};
+      for_each_([&](std::size_t y) {
+        const auto &e  = extents_[y];
+        const auto  x0 = std::max<coord_t>(e.x0, 0);
+        const auto  x1 = std::min(e.x1, width);
+        if (x0 < x1) {
+          out.push_back(DirtyRow{coord_t(y), x0, x1});
         }
-      }
+      });
       clear();
       return out;
     }
 
   private:
-    std::vector<std::uint8_t> flags_{};
+    struct Extent final {
+      coord_t x0 = 0;
+      coord_t x1 = 0;
+    };
+
+    // Call f(y) for every dirty row, in order.
+    template <class F> void for_each_(F &&f) const {
+      std::size_t left = count_;
+      for (std::size_t w = 0; left != 0 && w < bits_.size(); ++w) {
+        for (std::uint64_t word = bits_[w]; word != 0; word &= word - 1) {
+          f((w << 6) + std::size_t(std::countr_zero(word)));
+          --left;
+        }
+      }
+    }
+
+    std::vector<Extent>        extents_{};
+    std::vector<std::uint64_t> bits_{};
+    std::vector<std::uint64_t> stale_{};   // cached row hash out of date
+    std::vector<std::uint64_t> written_{}; // written since forget_written()
+    std::size_t                count_ = 0;
   };
 
   // ------------------------------------------------------------
@@ -123,14 +271,18 @@ namespace glyph::core {
   struct BufferView final {
     Cell          *data = nullptr;
     Size           size{};
-    std::ptrdiff_t stride = 0;
-    DirtyLines    *dirty  = nullptr;
+    std::ptrdiff_t stride   = 0;
+    DirtyLines    *dirty    = nullptr;
+    ClusterPool   *clusters = nullptr;
+    Point          origin{}; // where data sits in `dirty`'s coordinates
 
     constexpr BufferView() noexcept = default;
 
-    constexpr BufferView(
-        Cell *d, Size s, std::ptrdiff_t st, DirtyLines *dirty_) noexcept
-        : data(d), size(s), stride(st), dirty(dirty_) {
+    constexpr BufferView(Cell *d, Size s, std::ptrdiff_t st,
+                         DirtyLines *dirty_, ClusterPool *cl = nullptr,
+                         Point org = {}) noexcept
+        : data(d), size(s), stride(st), dirty(dirty_), clusters(cl),
+          origin(org) {
     }
 
     [[nodiscard]] constexpr bool empty() const noexcept {
@@ -171,16 +323,28 @@ namespace glyph::core {
           clipped.size,
           stride,
           dirty,
+          clusters,
+          Point{origin.x + clipped.origin.x, origin.y + clipped.origin.y},
       };
     }
 
+    // Record that the cells of `r` (view-local, clipped) were written.
+    void mark_dirty(Rect r) noexcept {
+      if (!dirty)
+        return;
+      const Rect c = r.intersect(bounds());
+      if (c.empty())
+        return;
+      dirty->mark_range(origin.y + c.top(), origin.y + c.bottom(),
+                        origin.x + c.left(), origin.x + c.right());
+    }
+
     // Fill entire view with a cell.
     void clear(const Cell &c = Cell{}) noexcept {
       if (empty())
         return;
 
-      if (dirty)
-        dirty->mark_range(0, size.h);
+      mark_dirty(bounds());
 
       for (coord_t y = 0; y < size.h; ++y) {
         for (coord_t x = 0; x < size.w; ++x) {
@@ -195,8 +359,7 @@ namespace glyph::core {
       if (clipped.empty())
         return;
 
-      if (dirty)
-        dirty->mark_range(clipped.origin.y, clipped.origin.y + clipped.size.h);
+      mark_dirty(clipped);
 
       auto sub = subview(clipped);
 
@@ -207,8 +370,9 @@ namespace glyph::core {
       }
     }
 
-    // Blit from a const view into this view at dst.
-    void blit(ConstBufferView src, Point dst) noexcept {
+    // Blit from a const view into this view at dst. Cluster cells from
+    // another pool are re-interned into this view's pool.
+    void blit(ConstBufferView src, Point dst) {
       if (empty() || src.empty())
         return;
 
@@ -217,28 +381,76 @@ namespace glyph::core {
       if (clipped.empty())
         return;
 
-      if (dirty)
-        dirty->mark_range(clipped.origin.y, clipped.origin.y + clipped.size.h);
+      mark_dirty(clipped);
 
       // Compute source start offset after clipping.
       const coord_t sx0 = coord_t(clipped.origin.x - dst.x);
       const coord_t sy0 = coord_t(clipped.origin.y - dst.y);
 
+      const bool import = clusters && src.clusters && src.clusters != clusters;
       for (coord_t y = 0; y < clipped.size.h; ++y) {
         for (coord_t x = 0; x < clipped.size.w; ++x) {
-          const auto &c = src.at(sx0 + x, sy0 + y);
+          Cell c = src.at(sx0 + x, sy0 + y);
+          if (import && is_cluster(c.ch))
+            c.ch = clusters->import(*src.clusters, c.ch);
           at(clipped.origin.x + x, clipped.origin.y + y) = c;
         }
       }
     }
 
+    // Shift rows [top, bottom) vertically by `shift` rows: positive moves
+    // content up (row y receives row y + shift), negative moves it down.
+    // Rows vacated by the shift are filled with `fill`.
+    void shift_rows(coord_t top, coord_t bottom, coord_t shift,
+                    const Cell &fill = Cell{}) noexcept {
+      top    = std::max<coord_t>(top, 0);
+      bottom = std::min<coord_t>(bottom, size.h);
+      if (empty() || top >= bottom || shift == 0)
+        return;
+
+      mark_dirty(Rect{0, top, size.w, bottom - top});
+
+      const coord_t n = bottom - top;
+      if (shift >= n || -shift >= n) {
+        fill_rect(Rect{0, top, size.w, n}, fill);
+        return;
+      }
+
+      auto copy_row = [&](coord_t dst_y, coord_t src_y) {
+        const Cell *src = &at(0, src_y);
+        std::copy(src, src + size.w, &at(0, dst_y));
+      };
+
+      if (shift > 0) {
+        for (coord_t y = top; y < bottom - shift; ++y) {
+          copy_row(y, y + shift);
+        }
+        fill_rect(Rect{0, bottom - shift, size.w, shift}, fill);
+      }
+      else {
+        for (coord_t y = bottom - 1; y >= top - shift; --y) {
+          copy_row(y, y + shift);
+        }
+        fill_rect(Rect{0, top, size.w, -shift}, fill);
+      }
+    }
+
+    // Store a grapheme cluster in this view's pool and return the value
+    // for Cell::ch (see ClusterPool::intern). Without a pool only the first
+    // codepoint survives.
+    char32_t intern_cluster(std::u32string_view cps) {
+      if (clusters)
+        return clusters->intern(cps);
+      return cps.empty() ? U' ' : cps[0];
+    }
+
     // Write a cell with width-aware placement.
     void put(Point p, Cell c) noexcept {
       if (p.x < 0 || p.y < 0 || p.x >= size.w || p.y >= size.h)
         return;
 
-      if (dirty)
-        dirty->mark(p.y);
+      // The wide-glyph fixups below may touch either neighbour.
+      mark_dirty(Rect{p.x - 1, p.y, 3, 1});
 
       // If overwriting a wide glyph's lead cell, clear its spacer.
       {
@@ -277,7 +489,7 @@ namespace glyph::core {
     }
 
     [[nodiscard]] constexpr ConstBufferView const_view() const noexcept {
-      return ConstBufferView{data, size, stride};
+      return ConstBufferView{data, size, stride, clusters};
     }
   };
 
@@ -291,6 +503,7 @@ namespace glyph::core {
     explicit Buffer(Size s)
         : size_(s), cells_(std::size_t(s.w) * std::size_t(s.h)) {
       dirty_.resize(s.h);
+      hashes_.resize(std::size_t(std::max<coord_t>(s.h, 0)));
     }
 
     [[nodiscard]] Size size() const noexcept {
@@ -307,6 +520,7 @@ namespace glyph::core {
           size_,
           stride_(),
           &dirty_,
+          &clusters_,
       };
     }
 
@@ -315,12 +529,29 @@ namespace glyph::core {
           cells_.data(),
           size_,
           stride_(),
+          &clusters_,
       };
     }
 
-    // Clear whole buffer.
+    // Clear whole buffer. Nothing refers to the stored clusters any more
+    // (unless `c` is one), so the pool starts over.
     void clear(const Cell &c = Cell{}) noexcept {
       view().clear(c);
+      dirty_.forget_written();
+      if (!is_cluster(c.ch))
+        clusters_.clear();
+    }
+
+    // Same result as clear(c), touching only the rows written since the
+    // last clear() / clear_written(). Only valid if that clear used the
+    // same `c`; writes through at() are not seen.
+    void clear_written(const Cell &c = Cell{}) noexcept {
+      auto v = view();
+      dirty_.take_written([&](coord_t y) {
+        v.fill_rect(Rect{0, y, size_.w, 1}, c);
+      });
+      if (!is_cluster(c.ch))
+        clusters_.clear();
     }
 
     // Fill a rect (clipped).
@@ -329,7 +560,7 @@ namespace glyph::core {
     }
 
     // Blit from a const view into this buffer at dst.
-    void blit(ConstBufferView src, Point dst) noexcept {
+    void blit(ConstBufferView src, Point dst) {
       view().blit(src, dst);
     }
 
@@ -339,6 +570,7 @@ namespace glyph::core {
         size_ = s;
         cells_.clear();
         dirty_.resize(s.h);
+        hashes_.assign(std::size_t(std::max<coord_t>(s.h, 0)), 0);
         return;
       }
 
@@ -360,6 +592,13 @@ namespace glyph::core {
       size_ = s;
       cells_.swap(next);
       dirty_.resize(s.h);
+      hashes_.assign(std::size_t(s.h), 0);
+    }
+
+    // Shift rows [top, bottom) vertically (see BufferView::shift_rows).
+    void shift_rows(coord_t top, coord_t bottom, coord_t shift,
+                    const Cell &fill = Cell{}) noexcept {
+      view().shift_rows(top, bottom, shift, fill);
     }
 
     // Backward-compatible name if you want to keep call sites stable.
@@ -368,10 +607,51 @@ namespace glyph::core {
       return const_view();
     }
 
+    // Grapheme clusters referenced by this buffer's cells.
+    [[nodiscard]] ClusterPool &clusters() noexcept {
+      return clusters_;
+    }
+    [[nodiscard]] const ClusterPool &clusters() const noexcept {
+      return clusters_;
+    }
+
     std::vector<coord_t> take_dirty_lines() const {
       return dirty_.take();
     }
 
+    // Dirty rows with their written column windows, into a reusable
+    // buffer (see DirtyLines::take_into).
+    std::span<const DirtyRow> take_dirty_into(std::vector<DirtyRow> &out) const {
+      return dirty_.take_into(out, size_.w);
+    }
+
+    [[nodiscard]] bool has_dirty_lines() const noexcept {
+      return dirty_.any();
+    }
+
+    // Drop the pending dirty lines without collecting them.
+    void clear_dirty_lines() const noexcept {
+      dirty_.clear();
+    }
+
+    // Hash of row y (hash_cells() over the row). Cached per row and
+    // recomputed only after the row was written through a view, so asking
+    // every frame costs one bit test per clean row.
+    [[nodiscard]] line_hash_t row_hash(coord_t y) const noexcept {
+      assert(y >= 0 && y < size_.h);
+      auto &h = hashes_[std::size_t(y)];
+      if (dirty_.take_stale(y)) {
+        h = hash_cells(cells_.data() + std::size_t(y) * std::size_t(size_.w),
+                       std::size_t(size_.w));
+      }
+      return h;
+    }
+
+    // Also mark the lines `other` has pending (see DirtyLines::merge).
+    void merge_dirty_lines(const Buffer &other) noexcept {
+      dirty_.merge(other.dirty_);
+    }
+
   private:
     [[nodiscard]] std::ptrdiff_t stride_() const noexcept {
       return std::ptrdiff_t(size_.w);
@@ -380,6 +660,9 @@ namespace glyph::core {
     Size               size_{0, 0};
     std::vector<Cell>  cells_{};
     mutable DirtyLines dirty_{};
+    ClusterPool        clusters_{};
+
+    mutable std::vector<line_hash_t> hashes_{}; // valid unless stale in dirty_
   };
 
 } // namespace glyph::core
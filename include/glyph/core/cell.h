@@ -15,9 +15,12 @@ namespace glyph::core {
 
   // Minimal "glyph" unit.
   struct Cell final {
-    char32_t     ch    = U' '; // single codepoint placeholder
+    char32_t     ch    = U' '; // codepoint, or a cluster tag (cluster.h)
     std::uint8_t width = 1;    // 0/1/2 columns
-    std::uint8_t _pad0 = 0;
+    // Reserved; nothing in Glyph sets them. They take part in equality, so
+    // operator==, the byte compares in row_compare.h and the row hashes in
+    // row_hash.h all look at the same 20 bytes.
+    std::uint8_t  _pad0 = 0;
     std::uint16_t _pad1 = 0;
     Style        style{};
 
@@ -32,7 +35,8 @@ namespace glyph::core {
     }
 
     friend constexpr bool operator==(Cell a, Cell b) noexcept {
-      return a.ch == b.ch && a.width == b.width && a.style == b.style;
+      return a.ch == b.ch && a.width == b.width && a._pad0 == b._pad0 &&
+             a._pad1 == b._pad1 && a.style == b.style;
     }
     friend constexpr bool operator!=(Cell a, Cell b) noexcept {
       return !(a == b);
@@ -0,0 +1,251 @@
+// glyph/core/cluster.h
+//
+// Grapheme cluster storage.
+//
+// Responsibilities:
+//   - Keep multi-codepoint grapheme clusters (ZWJ sequences, flags,
+//     combining marks) out of Cell: a cell holds either a plain codepoint
+//     or a tag referring to a cluster in a ClusterPool.
+//   - Store cluster bytes pre-encoded as UTF-8 in one arena, so encoders
+//     copy them straight to the output without allocating.
+//   - Derive tags from content, so equal clusters compare equal across
+//     pools (frames) and diffing keeps working on Cell::ch alone.
+//   - Let a long-lived pool adopt other pools' tags as they are, and
+//     report a tag that comes back naming different bytes.
+
+#pragma once
+
+#include "text.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace glyph::core {
+
+  // Cell::ch values with the top bit set are cluster tags. Unicode stops at
+  // 0x10FFFF, so plain codepoints never collide with them.
+  constexpr char32_t kClusterTag = 0x80000000u;
+
+  constexpr bool is_cluster(char32_t ch) noexcept {
+    return (ch & kClusterTag) != 0;
+  }
+
+  // Encode one codepoint as UTF-8 into out[0..4); returns the byte count.
+  // Invalid codepoints (surrogates, > 0x10FFFF) encode as U+FFFD.
+  constexpr std::size_t encode_utf8(char32_t cp, char *out) noexcept {
+    if (cp < 0x80) {
+      out[0] = char(cp);
+      return 1;
+    }
+    if (cp < 0x800) {
+      out[0] = char(0xC0 | (cp >> 6));
+      out[1] = char(0x80 | (cp & 0x3F));
+      return 2;
+    }
+    if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+      cp = 0xFFFD;
+    if (cp < 0x10000) {
+      out[0] = char(0xE0 | (cp >> 12));
+      out[1] = char(0x80 | ((cp >> 6) & 0x3F));
+      out[2] = char(0x80 | (cp & 0x3F));
+      return 3;
+    }
+    out[0] = char(0xF0 | (cp >> 18));
+    out[1] = char(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = char(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = char(0x80 | (cp & 0x3F));
+    return 4;
+  }
+
+  // ------------------------------------------------------------
+  // ClusterPool: per-frame arena of grapheme clusters
+  //
+  // A tag is kClusterTag | 31 bits of the cluster's UTF-8 hash. Two pools
+  // holding the same cluster hand out the same tag unless one of them had
+  // to probe past a collision, which is why blitting between pools goes
+  // through import(). So a tag is only unique within one pool: across
+  // frames two different clusters can share it. The renderer compares
+  // tags only, and keeps them exact by adopt()ing every frame's clusters
+  // into its shadow's pool, where a conflicting tag is caught.
+  //
+  // clear() drops every cluster but keeps the capacity, so a pool reused
+  // frame after frame stops allocating once it has seen its peak.
+  // ------------------------------------------------------------
+  class ClusterPool final {
+  public:
+    // Store a cluster and return the value for Cell::ch. A single
+    // codepoint is returned as-is; nothing is stored for it.
+    char32_t intern(std::u32string_view cps) {
+      if (cps.empty())
+        return U' ';
+      if (cps.size() == 1)
+        return cps[0];
+
+      const std::size_t off = arena_.size();
+      char              tmp[4];
+      for (char32_t cp : cps) {
+        arena_.append(tmp, encode_utf8(cp, tmp));
+      }
+      return commit_(off, cluster_width(cps));
+    }
+
+    // Copy cluster `ch` from `src` into this pool. Plain codepoints and
+    // unknown tags pass through unchanged.
+    char32_t import(const ClusterPool &src, char32_t ch) {
+      if (!is_cluster(ch) || &src == this)
+        return ch;
+      const Entry *e = src.find_(ch);
+      if (!e)
+        return ch;
+
+      const std::size_t off = arena_.size();
+      arena_.append(src.arena_, e->offset, e->len);
+      return commit_(off, e->width);
+    }
+
+    // Store cluster `tag` of `src` under that same tag, so cells copied
+    // verbatim from `src` resolve here too. Returns false, storing
+    // nothing, if this pool already holds different bytes under the tag.
+    // Plain codepoints and tags `src` does not know are accepted as-is.
+    bool adopt(const ClusterPool &src, char32_t tag) {
+      if (&src == this)
+        return true;
+      const Entry *e = src.find_(tag);
+      if (!e)
+        return true;
+      const std::string_view bytes{src.arena_.data() + e->offset, e->len};
+      if (const Entry *mine = find_(tag))
+        return std::string_view{arena_.data() + mine->offset, mine->len} ==
+               bytes;
+
+      if ((entries_.size() + 1) * 2 > slots_.size())
+        grow_();
+      entries_.push_back(Entry{tag, std::uint32_t(arena_.size()),
+                               e->len, e->width});
+      arena_.append(bytes);
+      insert_slot_(tag, std::uint32_t(entries_.size()));
+      return true;
+    }
+
+    // adopt() every cluster of `src`; false if any tag conflicted.
+    bool adopt_all(const ClusterPool &src) {
+      bool ok = true;
+      for (const Entry &e : src.entries_) {
+        ok = adopt(src, e.tag) && ok;
+      }
+      return ok;
+    }
+
+    // UTF-8 bytes of a cluster; empty if the tag is unknown.
+    [[nodiscard]] std::string_view utf8(char32_t tag) const noexcept {
+      const Entry *e = find_(tag);
+      if (!e)
+        return {};
+      return std::string_view{arena_.data() + e->offset, e->len};
+    }
+
+    // Display width of a cluster (0 if the tag is unknown).
+    [[nodiscard]] std::uint8_t width(char32_t tag) const noexcept {
+      const Entry *e = find_(tag);
+      return e ? e->width : std::uint8_t(0);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return entries_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+      return entries_.empty();
+    }
+
+    void clear() noexcept {
+      arena_.clear();
+      entries_.clear();
+      std::fill(slots_.begin(), slots_.end(), std::uint32_t(0));
+    }
+
+  private:
+    struct Entry final {
+      char32_t      tag    = 0;
+      std::uint32_t offset = 0;
+      std::uint32_t len    = 0;
+      std::uint8_t  width  = 0;
+    };
+
+    static constexpr std::size_t kMinSlots = 64;
+
+    static std::uint32_t hash_(std::string_view bytes) noexcept {
+      std::uint64_t h = 1469598103934665603ull;
+      for (unsigned char b : bytes) {
+        h ^= b;
+        h *= 1099511628211ull;
+      }
+      return std::uint32_t(h ^ (h >> 32));
+    }
+
+    static char32_t next_tag_(char32_t tag) noexcept {
+      return kClusterTag | ((tag + 1) & ~kClusterTag);
+    }
+
+    [[nodiscard]] const Entry *find_(char32_t tag) const noexcept {
+      if (slots_.empty() || !is_cluster(tag))
+        return nullptr;
+      const std::size_t mask = slots_.size() - 1;
+      for (std::size_t i = tag & mask;; i = (i + 1) & mask) {
+        const std::uint32_t s = slots_[i];
+        if (s == 0)
+          return nullptr;
+        if (entries_[s - 1].tag == tag)
+          return &entries_[s - 1];
+      }
+    }
+
+    // The bytes from `off` to the end of the arena form a new cluster:
+    // return the tag of an equal stored one (dropping the copy), or store
+    // it under the first free tag from its hash on.
+    char32_t commit_(std::size_t off, std::uint8_t width) {
+      const std::string_view bytes{arena_.data() + off, arena_.size() - off};
+      char32_t tag = kClusterTag | (hash_(bytes) & ~kClusterTag);
+      while (const Entry *e = find_(tag)) {
+        if (std::string_view{arena_.data() + e->offset, e->len} == bytes) {
+          arena_.resize(off);
+          return tag;
+        }
+        tag = next_tag_(tag);
+      }
+
+      if ((entries_.size() + 1) * 2 > slots_.size())
+        grow_();
+      entries_.push_back(Entry{tag, std::uint32_t(off),
+                               std::uint32_t(bytes.size()), width});
+      insert_slot_(tag, std::uint32_t(entries_.size()));
+      return tag;
+    }
+
+    void insert_slot_(char32_t tag, std::uint32_t slot) noexcept {
+      const std::size_t mask = slots_.size() - 1;
+      std::size_t       i    = tag & mask;
+      while (slots_[i] != 0) {
+        i = (i + 1) & mask;
+      }
+      slots_[i] = slot;
+    }
+
+    void grow_() {
+      slots_.assign(slots_.empty() ? kMinSlots : slots_.size() * 2,
+                    std::uint32_t(0));
+      for (std::size_t i = 0; i < entries_.size(); ++i) {
+        insert_slot_(entries_[i].tag, std::uint32_t(i + 1));
+      }
+    }
+
+    std::string                arena_{};
+    std::vector<Entry>         entries_{};
+    std::vector<std::uint32_t> slots_{}; // entry index + 1; 0 = free
+  };
+
+} // namespace glyph::core
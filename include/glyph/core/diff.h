@@ -6,21 +6,28 @@
 //  - Compute line hashes for quick change detection.
 //  - Generate minimal changes spans between two buffers.
 //  - Provide a simple path for dirty-line acceleration.
+//  - Detect vertical shifts of row blocks (scrolling) by line hash.
+//
+// Row comparisons run through the vectorized kernel in row_compare.h:
+// equal stretches are skipped as raw memory. Cell equality is byte
+// equality, so a flagged cell is a changed cell.
 
 #pragma once
 
 #include "buffer.h"
 #include "geometry.h"
+#include "row_compare.h"
+#include "row_hash.h"
 #include "types.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <initializer_list>
 #include <span>
 #include <vector>
 
 namespace glyph::core {
 
-  using line_hash_t = std::uint64_t;
-
   // A horizontal span on a specific row.
   // Range is [x0, x1), half-open.
   struct DiffSpan final {
@@ -33,53 +40,143 @@ namespace glyph::core {
     }
   };
 
-  // ------------------------------------------------------------
-  // FNV-1a helpers
-  // ------------------------------------------------------------
-  constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
-  constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
-
-  inline void fnv_add(std::uint64_t &h, std::uint64_t v) noexcept {
-    for (int i = 0; i < 8; ++i) {
-      const std::uint8_t b = std::uint8_t((v >> (i * 8)) & 0xffu);
-      h ^= b;
-      h *= kFnvPrime;
-    }
-  }
-
-  inline std::uint64_t hash_cell(const Cell &c) noexcept {
-    std::uint64_t h = kFnvOffset;
-
-    fnv_add(h, std::uint64_t(c.ch));
-    fnv_add(h, std::uint64_t(c.width));
-    fnv_add(h, std::uint64_t(c.style.fg_rgb));
-    fnv_add(h, std::uint64_t(c.style.bg_rgb));
-    fnv_add(h, std::uint64_t(c.style.attrs));
+  // A block of rows that moved vertically between two buffers.
+  // Within next rows [top, bottom), content equals prev shifted by `shift`:
+  //   shift > 0: scrolled up   (next[y] == prev[y + shift])
+  //   shift < 0: scrolled down (next[y] == prev[y + shift])
+  // [top, bottom) is the full scroll region, including the |shift| rows that
+  // the scroll exposes and that still need painting.
+  struct ScrollHint final {
+    coord_t top   = 0;
+    coord_t bottom = 0;
+    coord_t shift = 0;
 
-    return h;
-  }
+    [[nodiscard]] constexpr bool empty() const noexcept {
+      return shift == 0 || bottom <= top;
+    }
+  };
 
+  // Hash of row y (see hash_cells() in row_hash.h).
   inline line_hash_t hash_line(ConstBufferView v, coord_t y) noexcept {
-    std::uint64_t h = kFnvOffset;
-    for (coord_t x = 0; x < v.size.w; ++x) {
-      fnv_add(h, hash_cell(v.at(x, y)));
-    }
-    return h;
+    if (v.size.w <= 0)
+      return hash_cells(nullptr, 0);
+    return hash_cells(&v.at(0, y), std::size_t(v.size.w));
   }
 
-  // Compute per-line hashes for a buffer view.
-  inline std::vector<line_hash_t> line_hashes(ConstBufferView v) {
-    std::vector<line_hash_t> out;
+  // Compute per-line hashes for a buffer view into `out` (resized to fit).
+  inline void line_hashes(ConstBufferView v, std::vector<line_hash_t> &out) {
+    out.clear();
     if (v.empty())
-      return out;
+      return;
 
     out.resize(std::size_t(v.size.h));
     for (coord_t y = 0; y < v.size.h; ++y) {
       out[std::size_t(y)] = hash_line(v, y);
     }
+  }
+
+  // Compute per-line hashes for a buffer view.
+  inline std::vector<line_hash_t> line_hashes(ConstBufferView v) {
+    std::vector<line_hash_t> out;
+    line_hashes(v, out);
     return out;
   }
 
+  // Whether row py of prev and row ny of next hold identical cells.
+  // Cheaper than comparing two hash_line() results, and exact.
+  inline bool rows_equal(ConstBufferView prev, coord_t py, ConstBufferView next,
+                         coord_t ny) noexcept {
+    if (next.size.w <= 0)
+      return true;
+    const auto w = std::size_t(next.size.w);
+    return first_mismatch(&prev.at(0, py), &next.at(0, ny), w) == w;
+  }
+
+  // Find the vertical shift that saves the most row repaints.
+  //
+  // For every candidate shift d, looks for the longest run of consecutive
+  // rows with next_hash[y] == prev_hash[y + d], scored by how many of those
+  // rows differ in place (i.e. would otherwise be repainted). The best run
+  // is verified with `same_row(prev_y, next_y)` to rule out hash
+  // collisions. Returns an empty hint unless at least `min_rows` repaints
+  // are saved.
+  //
+  // Only whole-width rows are matched: terminal scroll regions (DECSTBM)
+  // span the full screen width.
+  template <class SameRow>
+  ScrollHint detect_scroll_by_hash(std::span<const line_hash_t> prev_hashes,
+                                   std::span<const line_hash_t> next_hashes,
+                                   coord_t                      min_rows,
+                                   SameRow                    &&same_row) {
+    const coord_t h = coord_t(next_hashes.size());
+    if (h == 0 || coord_t(prev_hashes.size()) != h)
+      return {};
+
+    coord_t best_gain  = 0;
+    coord_t best_a     = 0;
+    coord_t best_b     = 0;
+    coord_t best_shift = 0;
+
+    // Small shifts first; stop once no run could beat the best gain.
+    for (coord_t m = 1; m < h && h - m > best_gain; ++m) {
+      for (const coord_t d : {m, coord_t(-m)}) {
+        const coord_t y_lo = std::max<coord_t>(0, -d);
+        const coord_t y_hi = std::min<coord_t>(h, h - d);
+
+        coord_t run_start = y_lo;
+        coord_t gain      = 0;
+        for (coord_t y = y_lo; y <= y_hi; ++y) {
+          const bool match =
+              y < y_hi && next_hashes[std::size_t(y)] ==
+                              prev_hashes[std::size_t(y + d)];
+          if (match) {
+            if (next_hashes[std::size_t(y)] != prev_hashes[std::size_t(y)])
+              ++gain;
+            continue;
+          }
+          if (gain > best_gain) {
+            best_gain  = gain;
+            best_a     = run_start;
+            best_b     = y;
+            best_shift = d;
+          }
+          run_start = y + 1;
+          gain      = 0;
+        }
+      }
+    }
+
+    if (best_gain < min_rows)
+      return {};
+
+    for (coord_t y = best_a; y < best_b; ++y) {
+      if (!same_row(coord_t(y + best_shift), y))
+        return {};
+    }
+
+    ScrollHint hint{};
+    hint.shift  = best_shift;
+    hint.top    = std::min(best_a, coord_t(best_a + best_shift));
+    hint.bottom = std::max(best_b, coord_t(best_b + best_shift));
+    return hint;
+  }
+
+  // detect_scroll_by_hash() over two Cell views.
+  inline ScrollHint detect_scroll(
+      ConstBufferView              prev,
+      ConstBufferView              next,
+      std::span<const line_hash_t> prev_hashes,
+      std::span<const line_hash_t> next_hashes,
+      coord_t                      min_rows = 3) {
+    if (prev.size != next.size || next.empty() ||
+        coord_t(next_hashes.size()) != next.size.h)
+      return {};
+    return detect_scroll_by_hash(
+        prev_hashes, next_hashes, min_rows, [&](coord_t py, coord_t ny) {
+          return rows_equal(prev, py, next, ny);
+        });
+  }
+
   // Return lines that differ between prev and next.
   // If sizes differ, all lines in next are treated as dirty.
   inline std::vector<coord_t>
@@ -94,46 +191,89 @@ namespace glyph::core {
     }
 
     for (coord_t y = 0; y < next.size.h; ++y) {
-      if (hash_line(prev, y) != hash_line(next, y)) {
+      if (!rows_equal(prev, y, next, y)) {
         dirty.push_back(y);
       }
     }
     return dirty;
   }
 
-  // Compute minimal changed spans on specific lines.
-  inline std::vector<DiffSpan> diff_spans(
+  // Append the changed spans of row y within columns [x0, x1).
+  inline void diff_row(ConstBufferView prev, ConstBufferView next, coord_t y,
+                       coord_t x0, coord_t x1, std::vector<DiffSpan> &spans) {
+    const auto  w = std::size_t(x1);
+    const Cell *a = &prev.at(0, y);
+    const Cell *b = &next.at(0, y);
+
+    std::size_t x = std::size_t(x0);
+    while (x < w) {
+      // Skip the unchanged stretch in bulk.
+      x += first_mismatch(a + x, b + x, w - x);
+      if (x >= w)
+        break;
+
+      const std::size_t start = x;
+      while (x < w && a[x] != b[x]) {
+        ++x;
+      }
+      spans.push_back(DiffSpan{y, coord_t(start), coord_t(x)});
+    }
+  }
+
+  // Compute minimal changed spans on specific lines, appending to `spans`.
+  // Lets hot callers reuse one vector across frames.
+  inline void diff_spans(
       ConstBufferView          prev,
       ConstBufferView          next,
-      std::span<const coord_t> lines) {
-    std::vector<DiffSpan> spans;
-
+      std::span<const coord_t> lines,
+      std::vector<DiffSpan>   &spans) {
     if (prev.size.w != next.size.w || prev.size.h != next.size.h) {
       for (coord_t y = 0; y < next.size.h; ++y) {
         spans.push_back(DiffSpan{y, 0, next.size.w});
       }
-      return spans;
+      return;
     }
+    if (next.size.w <= 0)
+      return;
 
     for (coord_t y : lines) {
       if (y < 0 || y >= next.size.h)
         continue;
+      diff_row(prev, next, y, 0, next.size.w, spans);
+    }
+  }
 
-      coord_t x = 0;
-      while (x < next.size.w) {
-        if (prev.at(x, y) == next.at(x, y)) {
-          ++x;
-          continue;
-        }
-
-        const coord_t x0 = x;
-        while (x < next.size.w && prev.at(x, y) != next.at(x, y)) {
-          ++x;
-        }
-        spans.push_back(DiffSpan{y, x0, x});
+  // As above, scanning only each row's dirty column window: cells outside
+  // it are taken as unchanged.
+  inline void diff_spans(
+      ConstBufferView           prev,
+      ConstBufferView           next,
+      std::span<const DirtyRow> rows,
+      std::vector<DiffSpan>    &spans) {
+    if (prev.size.w != next.size.w || prev.size.h != next.size.h) {
+      for (coord_t y = 0; y < next.size.h; ++y) {
+        spans.push_back(DiffSpan{y, 0, next.size.w});
       }
+      return;
+    }
+
+    for (const auto &r : rows) {
+      if (r.y < 0 || r.y >= next.size.h)
+        continue;
+      const coord_t x0 = std::max<coord_t>(r.x0, 0);
+      const coord_t x1 = std::min(r.x1, next.size.w);
+      if (x0 < x1)
+        diff_row(prev, next, r.y, x0, x1, spans);
     }
+  }
 
+  // Compute minimal changed spans on specific lines.
+  inline std::vector<DiffSpan> diff_spans(
+      ConstBufferView          prev,
+      ConstBufferView          next,
+      std::span<const coord_t> lines) {
+    std::vector<DiffSpan> spans;
+    diff_spans(prev, next, lines, spans);
     return spans;
   }
 
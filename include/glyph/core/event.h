@@ -119,6 +119,29 @@ namespace glyph::core {
     std::u32string text; // UTF-32 for consistency with Cell::ch
   };
 
+  // ------------------------------------------------------------
+  // Terminal replies
+  // ------------------------------------------------------------
+  // Setting reported by DECRPM (answer to a DECRQM query).
+  enum class ModeState : std::uint8_t {
+    NotRecognized    = 0,
+    Set              = 1,
+    Reset            = 2,
+    PermanentlySet   = 3,
+    PermanentlyReset = 4,
+  };
+
+  struct ModeReportEvent final {
+    std::uint16_t mode        = 0;
+    ModeState     state       = ModeState::NotRecognized;
+    bool          dec_private = true; // CSI ? ... $ y
+
+    // Whether the terminal knows the mode and lets it be toggled.
+    [[nodiscard]] constexpr bool supported() const noexcept {
+      return state == ModeState::Set || state == ModeState::Reset;
+    }
+  };
+
   // ------------------------------------------------------------
   // Unified event
   // ------------------------------------------------------------
@@ -128,6 +151,7 @@ namespace glyph::core {
       MouseEvent,
       ResizeEvent,
       FocusEvent,
-      PasteEvent>;
+      PasteEvent,
+      ModeReportEvent>;
 
 } // namespace glyph::core
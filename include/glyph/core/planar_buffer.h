@@ -0,0 +1,375 @@
+// glyph/core/planar_buffer.h
+//
+// Structure-of-arrays cell storage.
+//
+// Responsibilities:
+//   - Own a 2D grid stored as separate planes: codepoints (u32), widths
+//     (u8) and styles, each row starting on a cache line.
+//   - Fill, blit and diff plane by plane, so an operation on one property
+//     (e.g. restyling a region) only touches that property's memory.
+//   - Convert to and from the array-of-structs Buffer / BufferView.
+//
+// Buffer stays the storage behind BufferView/Frame: their `Cell &at()`
+// contract needs whole Cell objects in memory. PlanarBuffer is for hot
+// paths that can work on planes directly (shadow buffers, bulk fills) and
+// crosses over with blit()/copy_to().
+
+#pragma once
+
+#include "buffer.h"
+#include "cell.h"
+#include "diff.h"
+#include "geometry.h"
+#include "row_compare.h"
+#include "style.h"
+#include "types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace glyph::core {
+
+  namespace detail {
+
+    // Heap array whose first element sits on a kAlign-byte boundary.
+    template <class T, std::size_t kAlign> class AlignedPlane final {
+    public:
+      AlignedPlane() = default;
+
+      explicit AlignedPlane(std::size_t n)
+          : data_(n ? static_cast<T *>(::operator new(
+                          n * sizeof(T), std::align_val_t{kAlign}))
+                    : nullptr),
+            size_(n) {
+      }
+
+      [[nodiscard]] T *data() noexcept {
+        return data_.get();
+      }
+      [[nodiscard]] const T *data() const noexcept {
+        return data_.get();
+      }
+      [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+      }
+
+    private:
+      struct Free final {
+        void operator()(T *p) const noexcept {
+          ::operator delete(p, std::align_val_t{kAlign});
+        }
+      };
+
+      std::unique_ptr<T, Free> data_{};
+      std::size_t              size_ = 0;
+    };
+
+  } // namespace detail
+
+  // ------------------------------------------------------------
+  // PlanarBuffer: owning SoA cell storage
+  // ------------------------------------------------------------
+  class PlanarBuffer final {
+  public:
+    // Every plane row starts on a boundary of this many bytes.
+    static constexpr std::size_t kRowAlign = 64;
+
+    PlanarBuffer() = default;
+
+    explicit PlanarBuffer(Size s, const Cell &fill = Cell{}) {
+      allocate_(s);
+      fill_rows_(0, size_.h, fill);
+      dirty_.resize(size_.h);
+    }
+
+    [[nodiscard]] Size size() const noexcept {
+      return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+      return size_.w <= 0 || size_.h <= 0;
+    }
+
+    // Elements per row in every plane (width rounded up so rows stay
+    // aligned).
+    [[nodiscard]] std::ptrdiff_t stride() const noexcept {
+      return stride_;
+    }
+
+    // ------------------------------------------------------------
+    // Plane access (row y, size().w valid elements)
+    // ------------------------------------------------------------
+    [[nodiscard]] char32_t *glyph_row(coord_t y) noexcept {
+      return glyphs_.data() + offset_(0, y);
+    }
+    [[nodiscard]] const char32_t *glyph_row(coord_t y) const noexcept {
+      return glyphs_.data() + offset_(0, y);
+    }
+    [[nodiscard]] std::uint8_t *width_row(coord_t y) noexcept {
+      return widths_.data() + offset_(0, y);
+    }
+    [[nodiscard]] const std::uint8_t *width_row(coord_t y) const noexcept {
+      return widths_.data() + offset_(0, y);
+    }
+    [[nodiscard]] Style *style_row(coord_t y) noexcept {
+      return styles_.data() + offset_(0, y);
+    }
+    [[nodiscard]] const Style *style_row(coord_t y) const noexcept {
+      return styles_.data() + offset_(0, y);
+    }
+
+    // ------------------------------------------------------------
+    // Cell access
+    // ------------------------------------------------------------
+    [[nodiscard]] Cell get(coord_t x, coord_t y) const noexcept {
+      assert(x >= 0 && x < size_.w);
+      assert(y >= 0 && y < size_.h);
+      const std::size_t i = offset_(x, y);
+      Cell              c{};
+      c.ch    = glyphs_.data()[i];
+      c.width = widths_.data()[i];
+      c.style = styles_.data()[i];
+      return c;
+    }
+
+    // Raw store (no wide-glyph fixups; see BufferView::put for those).
+    void set(Point p, const Cell &c) noexcept {
+      if (p.x < 0 || p.y < 0 || p.x >= size_.w || p.y >= size_.h)
+        return;
+      dirty_.mark(p.y);
+      const std::size_t i = offset_(p.x, p.y);
+      glyphs_.data()[i]   = c.ch;
+      widths_.data()[i]   = c.width;
+      styles_.data()[i]   = c.style;
+    }
+
+    // ------------------------------------------------------------
+    // Bulk operations
+    // ------------------------------------------------------------
+
+    // Fill the whole buffer.
+    void clear(const Cell &c = Cell{}) noexcept {
+      fill_rect(Rect{Point{0, 0}, size_}, c);
+    }
+
+    // Fill a rect (clipped) with a cell.
+    void fill_rect(Rect r, const Cell &c) noexcept {
+      const Rect clipped = r.intersect(Rect{Point{0, 0}, size_});
+      if (clipped.empty())
+        return;
+      dirty_.mark_range(clipped.top(), clipped.bottom());
+      for (coord_t y = clipped.top(); y < clipped.bottom(); ++y) {
+        const std::size_t i = offset_(clipped.left(), y);
+        const std::size_t n = std::size_t(clipped.width());
+        std::fill_n(glyphs_.data() + i, n, c.ch);
+        std::fill_n(widths_.data() + i, n, c.width);
+        std::fill_n(styles_.data() + i, n, c.style);
+      }
+    }
+
+    // Restyle a rect (clipped) without touching glyphs or widths.
+    void fill_style(Rect r, const Style &s) noexcept {
+      const Rect clipped = r.intersect(Rect{Point{0, 0}, size_});
+      if (clipped.empty())
+        return;
+      dirty_.mark_range(clipped.top(), clipped.bottom());
+      for (coord_t y = clipped.top(); y < clipped.bottom(); ++y) {
+        std::fill_n(styles_.data() + offset_(clipped.left(), y),
+                    std::size_t(clipped.width()), s);
+      }
+    }
+
+    // Copy `src` into this buffer at dst (clipped), plane by plane.
+    void blit(const PlanarBuffer &src, Point dst) noexcept {
+      const Rect clipped =
+          Rect{dst, src.size_}.intersect(Rect{Point{0, 0}, size_});
+      if (clipped.empty())
+        return;
+      dirty_.mark_range(clipped.top(), clipped.bottom());
+
+      const coord_t     sx = coord_t(clipped.left() - dst.x);
+      const coord_t     sy = coord_t(clipped.top() - dst.y);
+      const std::size_t n  = std::size_t(clipped.width());
+      for (coord_t y = 0; y < clipped.height(); ++y) {
+        const std::size_t s = src.offset_(sx, sy + y);
+        const std::size_t d = offset_(clipped.left(), clipped.top() + y);
+        std::copy_n(src.glyphs_.data() + s, n, glyphs_.data() + d);
+        std::copy_n(src.widths_.data() + s, n, widths_.data() + d);
+        std::copy_n(src.styles_.data() + s, n, styles_.data() + d);
+      }
+    }
+
+    // Copy an array-of-structs view into this buffer at dst (clipped).
+    void blit(ConstBufferView src, Point dst) noexcept {
+      if (src.empty())
+        return;
+      const Rect clipped =
+          Rect{dst, src.size}.intersect(Rect{Point{0, 0}, size_});
+      if (clipped.empty())
+        return;
+      dirty_.mark_range(clipped.top(), clipped.bottom());
+
+      const coord_t sx = coord_t(clipped.left() - dst.x);
+      const coord_t sy = coord_t(clipped.top() - dst.y);
+      for (coord_t y = 0; y < clipped.height(); ++y) {
+        const Cell *row = &src.at(sx, sy + y);
+        const auto  d   = offset_(clipped.left(), clipped.top() + y);
+        for (coord_t x = 0; x < clipped.width(); ++x) {
+          glyphs_.data()[d + std::size_t(x)] = row[x].ch;
+          widths_.data()[d + std::size_t(x)] = row[x].width;
+          styles_.data()[d + std::size_t(x)] = row[x].style;
+        }
+      }
+    }
+
+    // Write this buffer into an array-of-structs view at the origin
+    // (clipped to both sizes).
+    void copy_to(BufferView dst) const noexcept {
+      if (dst.empty() || empty())
+        return;
+      const coord_t w = std::min(size_.w, dst.size.w);
+      const coord_t h = std::min(size_.h, dst.size.h);
+      dst.mark_dirty(Rect{0, 0, w, h});
+      for (coord_t y = 0; y < h; ++y) {
+        const std::size_t s   = offset_(0, y);
+        Cell             *row = &dst.at(0, y);
+        for (coord_t x = 0; x < w; ++x) {
+          Cell c{};
+          c.ch    = glyphs_.data()[s + std::size_t(x)];
+          c.width = widths_.data()[s + std::size_t(x)];
+          c.style = styles_.data()[s + std::size_t(x)];
+          row[x]  = c;
+        }
+      }
+    }
+
+    // Resize, preserving the overlapping region.
+    void resize(Size s, const Cell &fill = Cell{}) {
+      PlanarBuffer next{s, fill};
+      next.blit(*this, Point{0, 0});
+      next.dirty_.resize(next.size_.h);
+      *this = std::move(next);
+    }
+
+    std::vector<coord_t> take_dirty_lines() const {
+      return dirty_.take();
+    }
+
+  private:
+    void allocate_(Size s) {
+      size_ = s;
+      if (s.w <= 0 || s.h <= 0) {
+        stride_ = 0;
+        glyphs_ = {};
+        widths_ = {};
+        styles_ = {};
+        return;
+      }
+      // A multiple of 64 elements keeps every plane's rows on a 64-byte
+      // boundary whatever the element size.
+      stride_ = std::ptrdiff_t((std::size_t(s.w) + kRowAlign - 1) /
+                               kRowAlign * kRowAlign);
+      const std::size_t n = std::size_t(stride_) * std::size_t(s.h);
+      glyphs_ = detail::AlignedPlane<char32_t, kRowAlign>{n};
+      widths_ = detail::AlignedPlane<std::uint8_t, kRowAlign>{n};
+      styles_ = detail::AlignedPlane<Style, kRowAlign>{n};
+    }
+
+    void fill_rows_(coord_t y0, coord_t y1, const Cell &c) noexcept {
+      if (empty())
+        return;
+      const std::size_t a = offset_(0, y0);
+      const std::size_t n = std::size_t(y1 - y0) * std::size_t(stride_);
+      std::fill_n(glyphs_.data() + a, n, c.ch);
+      std::fill_n(widths_.data() + a, n, c.width);
+      std::uninitialized_fill_n(styles_.data() + a, n, c.style);
+    }
+
+    [[nodiscard]] std::size_t offset_(coord_t x, coord_t y) const noexcept {
+      return std::size_t(y) * std::size_t(stride_) + std::size_t(x);
+    }
+
+    Size                                          size_{0, 0};
+    std::ptrdiff_t                                stride_ = 0;
+    detail::AlignedPlane<char32_t, kRowAlign>     glyphs_{};
+    detail::AlignedPlane<std::uint8_t, kRowAlign> widths_{};
+    detail::AlignedPlane<Style, kRowAlign>        styles_{};
+    mutable DirtyLines                            dirty_{};
+  };
+
+  // ------------------------------------------------------------
+  // Planar diff
+  // ------------------------------------------------------------
+
+  // Compute minimal changed spans on specific lines, appending to `spans`.
+  // Each plane is scanned as raw memory (see row_compare.h); a cell
+  // differs when any of its planes does.
+  inline void diff_spans(const PlanarBuffer      &prev,
+                         const PlanarBuffer      &next,
+                         std::span<const coord_t> lines,
+                         std::vector<DiffSpan>   &spans) {
+    const Size size = next.size();
+    if (prev.size() != size) {
+      for (coord_t y = 0; y < size.h; ++y) {
+        spans.push_back(DiffSpan{y, 0, size.w});
+      }
+      return;
+    }
+    if (size.w <= 0)
+      return;
+
+    const auto w = std::size_t(size.w);
+    for (coord_t y : lines) {
+      if (y < 0 || y >= size.h)
+        continue;
+
+      const char32_t     *ga = prev.glyph_row(y);
+      const char32_t     *gb = next.glyph_row(y);
+      const std::uint8_t *wa = prev.width_row(y);
+      const std::uint8_t *wb = next.width_row(y);
+      const Style        *sa = prev.style_row(y);
+      const Style        *sb = next.style_row(y);
+
+      auto differs = [&](std::size_t x) {
+        return ga[x] != gb[x] || wa[x] != wb[x] || sa[x] != sb[x];
+      };
+
+      // First mismatch at or after the walk position, per plane. A plane is
+      // only rescanned once the walk has passed its cached position.
+      auto scan = [&](const void *a, const void *b, std::size_t elem,
+                      std::size_t from) {
+        const auto *pa = static_cast<const unsigned char *>(a) + from * elem;
+        const auto *pb = static_cast<const unsigned char *>(b) + from * elem;
+        return from + first_mismatch_bytes(pa, pb, (w - from) * elem) / elem;
+      };
+      std::size_t next_g = scan(ga, gb, sizeof(char32_t), 0);
+      std::size_t next_w = scan(wa, wb, sizeof(std::uint8_t), 0);
+      std::size_t next_s = scan(sa, sb, sizeof(Style), 0);
+
+      std::size_t x = 0;
+      while (x < w) {
+        if (next_g < x)
+          next_g = scan(ga, gb, sizeof(char32_t), x);
+        if (next_w < x)
+          next_w = scan(wa, wb, sizeof(std::uint8_t), x);
+        if (next_s < x)
+          next_s = scan(sa, sb, sizeof(Style), x);
+        x = std::min({next_g, next_w, next_s});
+        if (x >= w)
+          break;
+
+        const std::size_t x0 = x;
+        while (x < w && differs(x)) {
+          ++x;
+        }
+        spans.push_back(DiffSpan{y, coord_t(x0), coord_t(x)});
+      }
+    }
+  }
+
+} // namespace glyph::core
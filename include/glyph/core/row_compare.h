@@ -0,0 +1,56 @@
+// glyph/core/row_compare.h
+//
+// Vectorized row comparison.
+//
+// Responsibilities:
+//   - Find the first cell at which two rows differ, comparing whole rows as
+//     raw memory (SSE2/AVX2, picked at runtime, with a scalar fallback).
+//   - Back rows_equal() and diff_spans() in diff.h.
+//
+// Cells are compared byte-for-byte. Cell has no implicit padding and its
+// operator== compares every field, pad fields included, so byte equality
+// is Cell equality.
+
+#pragma once
+
+#include "cell.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace glyph::core {
+
+  enum class RowCompareIsa : std::uint8_t {
+    Scalar,
+    Sse2,
+    Avx2,
+  };
+
+  // Best kernel the running CPU supports (detected once).
+  [[nodiscard]] RowCompareIsa row_compare_isa() noexcept;
+
+  // Whether `isa` can run on this CPU.
+  [[nodiscard]] bool row_compare_supported(RowCompareIsa isa) noexcept;
+
+  [[nodiscard]] const char *to_string(RowCompareIsa isa) noexcept;
+
+  // Index of the first cell in [0, n) whose bytes differ between a and b,
+  // or n if the ranges are identical.
+  [[nodiscard]] std::size_t
+  first_mismatch(const Cell *a, const Cell *b, std::size_t n) noexcept;
+
+  // Offset of the first differing byte in [0, bytes), or `bytes` if the
+  // ranges are identical. For callers with their own element layout
+  // (e.g. PlanarBuffer planes).
+  [[nodiscard]] std::size_t first_mismatch_bytes(const void *a,
+                                                 const void *b,
+                                                 std::size_t bytes) noexcept;
+
+  // Same, forcing a specific kernel (tests and benchmarks). `isa` must be
+  // supported.
+  [[nodiscard]] std::size_t first_mismatch(RowCompareIsa isa,
+                                           const Cell   *a,
+                                           const Cell   *b,
+                                           std::size_t   n) noexcept;
+
+} // namespace glyph::core
@@ -0,0 +1,48 @@
+// glyph/core/row_hash.h
+//
+// Row hashing over raw cell memory.
+//
+// Responsibilities:
+//   - Hash a row of Cells as one contiguous byte range with a word-at-a-time
+//     64-bit hash (wyhash-style by default).
+//   - Let the backend be chosen at build time (GLYPH_ROW_HASH in CMake) so
+//     alternatives can be A/B tested, and still reachable by name from
+//     tests and benchmarks.
+//   - Back Buffer's cached row hashes and hash_line() in diff.h.
+//
+// Like row_compare.h this relies on Cell having no implicit padding and
+// on Cell::operator== comparing every byte (pad fields included), so
+// equal rows hash equal. Hashes are for change detection only; they are
+// not stable across versions or backends.
+
+#pragma once
+
+#include "cell.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace glyph::core {
+
+  using line_hash_t = std::uint64_t;
+
+  enum class RowHash : std::uint8_t {
+    Wyhash, // 64x64->128 multiply-mix, 48 bytes per step
+    Fnv1a,  // byte-wise FNV-1a (reference / fallback)
+  };
+
+  // Backend hash_cells() was built with.
+  [[nodiscard]] RowHash row_hash_kind() noexcept;
+
+  [[nodiscard]] const char *to_string(RowHash kind) noexcept;
+
+  // Hash n consecutive cells with the built-in backend.
+  [[nodiscard]] line_hash_t hash_cells(const Cell *cells,
+                                       std::size_t n) noexcept;
+
+  // Same, forcing a specific backend (tests and benchmarks).
+  [[nodiscard]] line_hash_t hash_cells(RowHash     kind,
+                                       const Cell *cells,
+                                       std::size_t n) noexcept;
+
+} // namespace glyph::core
@@ -0,0 +1,101 @@
+// glyph/core/style_table.h
+//
+// Style interning.
+//
+// Responsibilities:
+//   - Map each distinct Style to a small integer id (style_id_t), so cells
+//     can store 2 bytes instead of 12 and compare styles as integers.
+//   - Give the Style back for an id.
+//
+// Ids are stable until clear(). The table only grows; once all 65535 ids
+// are taken intern() reports kFull and the owner is expected to clear()
+// and rebuild whatever held ids (see AnsiRenderer).
+
+#pragma once
+
+#include "style.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glyph::core {
+
+  using style_id_t = std::uint16_t;
+
+  class StyleTable final {
+  public:
+    // Style{} is always interned first.
+    static constexpr style_id_t kDefault = 0;
+    // intern() result when no id is left.
+    static constexpr style_id_t kFull = 0xFFFF;
+
+    StyleTable() {
+      clear();
+    }
+
+    // Id of `s`, adding it if new; kFull if the table is full.
+    [[nodiscard]] style_id_t intern(const Style &s) {
+      std::size_t i = slot_(s);
+      for (;;) {
+        const style_id_t id = index_[i];
+        if (id == kFull)
+          break;
+        if (styles_[id] == s)
+          return id;
+        i = (i + 1) & (index_.size() - 1);
+      }
+      if (styles_.size() >= kFull)
+        return kFull;
+
+      const auto id = style_id_t(styles_.size());
+      styles_.push_back(s);
+      index_[i] = id;
+      if (styles_.size() * 2 > index_.size()) {
+        rehash_(index_.size() * 2);
+      }
+      return id;
+    }
+
+    [[nodiscard]] const Style &style(style_id_t id) const noexcept {
+      return styles_[id];
+    }
+
+    // Number of interned styles (including the default).
+    [[nodiscard]] std::size_t size() const noexcept {
+      return styles_.size();
+    }
+
+    // Drop every id except kDefault.
+    void clear() {
+      styles_.clear();
+      styles_.push_back(Style{});
+      rehash_(kInitialSlots);
+    }
+
+  private:
+    static constexpr std::size_t kInitialSlots = 64; // power of two
+
+    [[nodiscard]] std::size_t slot_(const Style &s) const noexcept {
+      std::uint64_t h = (std::uint64_t(s.fg_rgb) << 32) | s.bg_rgb;
+      h ^= (std::uint64_t(s.attrs) << 16 | s.flags) * 0xC2B2AE3D27D4EB4Full;
+      h *= 0x9E3779B97F4A7C15ull;
+      return std::size_t(h >> 32) & (index_.size() - 1);
+    }
+
+    void rehash_(std::size_t slots) {
+      index_.assign(slots, kFull);
+      for (std::size_t id = 0; id < styles_.size(); ++id) {
+        std::size_t i = slot_(styles_[id]);
+        while (index_[i] != kFull) {
+          i = (i + 1) & (index_.size() - 1);
+        }
+        index_[i] = style_id_t(id);
+      }
+    }
+
+    std::vector<Style>      styles_{};
+    std::vector<style_id_t> index_{}; // open addressing; kFull marks empty
+  };
+
+} // namespace glyph::core
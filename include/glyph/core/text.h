@@ -3,62 +3,147 @@
 // Text helpers (codepoint-level)
 //
 // Responsibilities:
-//   - Provide a minimal, deterministic width rule for a single Unicode
-//     codepoint.
+//   - Provide a deterministic, table-driven width rule for a single
+//     Unicode codepoint.
+//   - Split text into grapheme clusters (the subset of UAX #29 terminals
+//     render as one glyph: combining marks, variation selectors, emoji
+//     modifiers, ZWJ sequences, flag pairs, tag sequences) and size them.
 //   - Keep core independent from heavy unicode libraries (ICU, etc).
 
 #pragma once
 
+#include "detail/width_data.h"
+
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace glyph::core {
 
-  // Width policy placeholder for future grapheme support.
+  // How text is cut into cells.
   enum class WidthPolicy : std::uint8_t {
-    Codepoint = 0,
-    Grapheme  = 1, // reserved; not implemented
+    Codepoint = 0, // one codepoint per cell
+    Grapheme  = 1, // one grapheme cluster per cell (see next_grapheme)
   };
 
   // Return display width for a single codepoint.
-  // 0 = non-printing/control, 1 = narrow, 2 = wide (CJK/fullwidth/emoji).
+  // 0 = non-printing (controls, combining/enclosing marks, format
+  // characters), 1 = narrow, 2 = wide (East Asian Wide/Fullwidth, emoji
+  // presentation, regional indicators).
   //
-  // This is a codepoint-level rule (phase 1). It marks codepoints that are
-  // wide on their own. Sequence-level cases — symbols that are narrow by
-  // default but become wide with an emoji variation selector (U+FE0F), ZWJ
-  // sequences, regional-indicator flag pairs, skin-tone modifiers — need a
-  // grapheme-aware pass (reserved WidthPolicy::Grapheme) and are not handled
-  // here. Notably 0x2600-0x27BF (misc symbols / dingbats) default to text
-  // presentation (width 1) and are intentionally not widened at this level.
+  // O(1) for every codepoint: an ASCII fast path, then two table lookups in
+  // detail/width_data.h (~11 KiB, generated by tools/gen_width_data.py from
+  // the Unicode East Asian Width and category data). It marks codepoints
+  // that are wide on their own. Sequence-level cases — symbols that are
+  // narrow by default but become wide with an emoji variation selector
+  // (U+FE0F), ZWJ sequences, flag pairs, skin-tone modifiers — are sized
+  // by cluster_width() below. Values outside Unicode (including cluster
+  // tags) report 1.
   constexpr std::uint8_t cell_width(char32_t c) noexcept {
-    if (c == U'\0')
-      return 0;
-    if (c < 0x20 || c == 0x7F)
-      return 0;
+    if (c < 0x7F)
+      return c >= 0x20 ? 1 : 0;
+    if (c > 0x10FFFF)
+      return 1;
+    const auto *blk  = detail::kWidthBlocks[detail::kWidthIndex[c >> 8]];
+    const auto  bits = blk[(c & 0xFF) >> 2] >> ((c & 3) * 2);
+    return std::uint8_t(bits & 3);
+  }
 
-    // CJK / fullwidth (Basic Multilingual Plane).
-    if ((c >= 0x1100 && c <= 0x115F) || (c >= 0x2E80 && c <= 0xA4CF) ||
-        (c >= 0xAC00 && c <= 0xD7A3) || (c >= 0xF900 && c <= 0xFAFF) ||
-        (c >= 0xFE10 && c <= 0xFE19) || (c >= 0xFE30 && c <= 0xFE6F) ||
-        (c >= 0xFF00 && c <= 0xFF60) || (c >= 0xFFE0 && c <= 0xFFE6))
-      return 2;
+  // A single codepoint is its own cluster under either policy.
+  constexpr std::uint8_t cell_width(char32_t c, WidthPolicy policy) noexcept {
+    (void)policy;
+    return cell_width(c);
+  }
 
-    // Emoji / pictographs that are wide on their own (Supplementary
-    // Multilingual Plane). Coarse ranges covering the blocks users actually
-    // type; over-coverage hits only unassigned codepoints, which is benign.
-    if (c == 0x1F004 ||                   // mahjong red dragon
-        c == 0x1F0CF ||                   // playing card black joker
-        (c >= 0x1F1E6 && c <= 0x1F1FF) || // regional indicators (flags)
-        (c >= 0x1F200 && c <= 0x1F2FF) || // enclosed ideographic supplement
-        (c >= 0x1F300 && c <= 0x1FAFF))   // pictographs / symbols / ext-A
-      return 2;
+  // ------------------------------------------------------------
+  // Grapheme clusters
+  // ------------------------------------------------------------
+  constexpr char32_t kZeroWidthJoiner   = 0x200D;
+  constexpr char32_t kEmojiPresentation = 0xFE0F; // VS16
 
-    return 1;
+  constexpr bool is_regional_indicator(char32_t c) noexcept {
+    return c >= 0x1F1E6 && c <= 0x1F1FF;
   }
 
-  // TODO: Future extension point.
-  // For now, callers should use cell_width(c).
-  constexpr std::uint8_t cell_width(char32_t c, WidthPolicy policy) noexcept {
-    return (policy == WidthPolicy::Codepoint) ? cell_width(c) : cell_width(c);
+  // Codepoints that attach to the preceding one (Grapheme_Cluster_Break
+  // Extend/SpacingMark/ZWJ, restricted to the blocks seen in terminal
+  // text).
+  constexpr bool is_grapheme_extend(char32_t c) noexcept {
+    return (c >= 0x0300 && c <= 0x036F) ||   // combining diacritics
+           (c >= 0x0483 && c <= 0x0489) ||   // Cyrillic combining
+           (c >= 0x0591 && c <= 0x05BD) ||   // Hebrew points
+           (c >= 0x0610 && c <= 0x061A) ||   // Arabic marks
+           (c >= 0x064B && c <= 0x065F) ||   //
+           (c >= 0x0900 && c <= 0x0903) ||   // Devanagari signs
+           (c >= 0x093A && c <= 0x094F) ||   //
+           (c >= 0x0E31 && c <= 0x0E3A && c != 0x0E32 && c != 0x0E33) ||
+           (c >= 0x0E47 && c <= 0x0E4E) ||   // Thai marks
+           (c >= 0x1AB0 && c <= 0x1AFF) ||   // combining diacritics ext.
+           (c >= 0x1DC0 && c <= 0x1DFF) ||   // combining diacritics supp.
+           c == kZeroWidthJoiner ||          //
+           (c >= 0x20D0 && c <= 0x20FF) ||   // combining marks for symbols
+           (c >= 0x3099 && c <= 0x309A) ||   // kana voicing marks
+           (c >= 0xFE00 && c <= 0xFE0F) ||   // variation selectors
+           (c >= 0xFE20 && c <= 0xFE2F) ||   // combining half marks
+           (c >= 0x1F3FB && c <= 0x1F3FF) || // emoji skin-tone modifiers
+           (c >= 0xE0020 && c <= 0xE007F) || // tag sequence characters
+           (c >= 0xE0100 && c <= 0xE01EF);   // variation selectors supp.
+  }
+
+  // Codepoints a ZWJ can join (Extended_Pictographic, coarse ranges).
+  constexpr bool is_pictographic(char32_t c) noexcept {
+    return c == 0x00A9 || c == 0x00AE || (c >= 0x2190 && c <= 0x21FF) ||
+           (c >= 0x2300 && c <= 0x23FF) || (c >= 0x2600 && c <= 0x27BF) ||
+           (c >= 0x2B00 && c <= 0x2BFF) || (c >= 0x1F000 && c <= 0x1FAFF);
+  }
+
+  // End (exclusive) of the grapheme cluster starting at text[i].
+  constexpr std::size_t next_grapheme(std::u32string_view text,
+                                      std::size_t         i) noexcept {
+    const std::size_t n = text.size();
+    if (i >= n)
+      return n;
+    if (text[i] == U'\r' && i + 1 < n && text[i + 1] == U'\n')
+      return i + 2;
+    if (text[i] < 0x20 || text[i] == 0x7F)
+      return i + 1;
+
+    std::size_t j = i + 1;
+    // Flags are pairs of regional indicators.
+    if (is_regional_indicator(text[i]) && j < n &&
+        is_regional_indicator(text[j])) {
+      ++j;
+    }
+    while (j < n) {
+      const char32_t c = text[j];
+      if (is_grapheme_extend(c) ||
+          (text[j - 1] == kZeroWidthJoiner && is_pictographic(c))) {
+        ++j;
+        continue;
+      }
+      break;
+    }
+    return j;
+  }
+
+  // Display width of one grapheme cluster. Emoji presentation (VS16), a
+  // flag pair, a skin-tone modifier or a ZWJ sequence make it wide;
+  // otherwise the base codepoint decides.
+  constexpr std::uint8_t cluster_width(std::u32string_view cluster) noexcept {
+    if (cluster.empty())
+      return 0;
+    const std::uint8_t base = cell_width(cluster[0]);
+    if (cluster.size() == 1 || base == 2)
+      return base;
+    if (is_regional_indicator(cluster[0]))
+      return 2;
+    for (std::size_t i = 1; i < cluster.size(); ++i) {
+      const char32_t c = cluster[i];
+      if (c == kEmojiPresentation || (c >= 0x1F3FB && c <= 0x1F3FF) ||
+          (c == kZeroWidthJoiner && is_pictographic(cluster[0])))
+        return 2;
+    }
+    return base;
   }
 
 } // namespace glyph::core
\ No newline at end of file
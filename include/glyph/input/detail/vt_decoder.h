@@ -5,6 +5,7 @@
 // Responsibilities:
 //   - Translate a stream of code points (already UTF-32) into core::Event.
 //   - Handle CSI / SS3 cursor & function keys, SGR mouse, bracketed paste.
+//   - Decode terminal replies the renderer asks for (DECRPM mode reports).
 //   - Stay platform-agnostic: no OS API, no IO. Both the POSIX and the
 //     Win32 (VT mode) backends feed bytes here.
 //
@@ -65,6 +66,7 @@ namespace glyph::input::detail {
     void step_csi(char32_t ch);
     void finish_sgr_mouse(char32_t final_ch);
     void finish_csi_tilde();
+    void finish_mode_report();
 
     void emit_char(char32_t ch, core::Mod mods);
     void emit_key(core::KeyCode code, core::Mod mods);
@@ -4,32 +4,258 @@
 //
 // Responsibilities:
 //   - Consume a view::Frame and emit ANSI sequences + glyphs.
-//   - Full redraw on first frame or size change.
+//   - Full redraw on first frame or size change: clear, then send only the
+//     cells that are not default blanks. Optionally debounced on resize.
 //   - Diff-based updates on dirty lines between frames.
+//   - Optionally spread large updates over several calls under a byte
+//     budget, keeping the shadow buffer equal to what was really sent.
+//
+// Each frame is encoded into a renderer-owned byte arena and handed to an
+// OutputSink in a single write; the arena and scratch vectors are reused,
+// so steady-state frames do not allocate.
+//
+// Every render()/render_pending() call records a RenderStats (work counts,
+// bytes, per-stage times) and pushes it into a rolling window.
 
 #pragma once
 
 #include "glyph/core/buffer.h"
+#include "glyph/core/diff.h"
+#include "glyph/core/style_table.h"
+#include "glyph/render/ansi/cursor_motion.h"
+#include "glyph/render/ansi/palette.h"
+#include "glyph/render/ansi/sgr_cache.h"
+#include "glyph/render/output.h"
 #include "glyph/render/render.h"
+#include "glyph/render/render_stats.h"
 #include "glyph/view/frame.h"
+#include <chrono>
 #include <iosfwd>
+#include <memory>
+#include <vector>
 namespace glyph::render {
 
+  // ------------------------------------------------------------
+  // AnsiRendererOptions
+  // ------------------------------------------------------------
+  struct AnsiRendererOptions final {
+    // Detect row blocks that moved vertically (log tails, transcripts) and
+    // shift them with a scroll region (DECSTBM + SU/SD) instead of
+    // repainting every row.
+    bool scroll_regions = true;
+
+    // Color depth of the target terminal. Colors are quantized to the
+    // nearest palette entry below true color.
+    ColorMode color_mode = ColorMode::TrueColor;
+
+    // Bracket every frame in synchronized-update mode (?2026h ... ?2026l) so
+    // the terminal repaints once per frame. Only enable this for terminals
+    // that reported support (see TerminalApp::handle_event).
+    bool synchronized_output = false;
+
+    // Clear runs of blank cells with EL (to end of line) or ECH instead of
+    // printing spaces. Relies on erase using the current background (bce),
+    // which every VT-compatible terminal in use does.
+    bool erase_blanks = true;
+
+    // Encode runs of one repeated glyph with REP (CSI n b). Not every
+    // terminal implements REP, so this is opt-in.
+    bool repeat_glyphs = false;
+
+    // When the sink still holds undelivered bytes (NonBlockingFdSink on a
+    // congested link), skip the frame instead of queueing more. The newest
+    // skipped frame is kept; once the queue drains, render_pending() (or
+    // the next render()) diffs it in full against the shadow, so the
+    // display jumps straight to the newest state.
+    bool skip_congested_frames = true;
+
+    // Soft cap on bytes encoded per render (0: unlimited). Once reached,
+    // the remaining spans stay pending and go out on later calls (see
+    // render_pending()); the shadow only tracks what was really sent.
+    std::size_t byte_budget = 0;
+
+    // Hold the full redraw after a size change until the size has stayed
+    // the same this long (0: redraw at once). Frames arriving meanwhile
+    // are kept, not drawn; the newest goes out on the first render() or
+    // render_pending() after the quiet period, so a window drag costs one
+    // redraw instead of one per step. Nothing else draws it: a caller that
+    // renders only on input must keep calling render_pending() while
+    // has_pending() is true (TerminalApp forwards both).
+    std::chrono::milliseconds resize_debounce{0};
+  };
+
   class AnsiRenderer final : public Renderer {
   public:
-    explicit AnsiRenderer(std::ostream &out) noexcept;
+    // Write through an std::ostream (wrapped in an internal OstreamSink).
+    explicit AnsiRenderer(std::ostream &out, AnsiRendererOptions options = {});
+
+    // Write through a caller-owned sink (e.g. FdSink for a raw terminal fd).
+    explicit AnsiRenderer(OutputSink         &sink,
+                          AnsiRendererOptions options = {});
 
     void render(const view::Frame &frame) override;
     void reset() noexcept;
 
+    // Flush the sink, then continue a frame the byte budget cut short,
+    // draw the frame kept from a congested skip, or draw a frame held by
+    // resize_debounce once it is due. Returns true while anything is still
+    // pending afterwards.
+    bool render_pending();
+    [[nodiscard]] bool has_pending() const noexcept {
+      return pending_ || resize_held_ || sink_.bytes_outstanding() != 0;
+    }
+
+    // Spans inside `r` go out first when the byte budget truncates a frame
+    // (e.g. the focused pane). An empty rect clears the hint.
+    void set_priority_region(glyph::core::Rect r) noexcept {
+      priority_ = r;
+    }
+
+    // Change the color depth; the next frame is a full redraw.
+    void set_color_mode(ColorMode mode) noexcept;
+    [[nodiscard]] ColorMode color_mode() const noexcept {
+      return options_.color_mode;
+    }
+
+    void set_synchronized_output(bool enabled) noexcept {
+      options_.synchronized_output = enabled;
+    }
+    [[nodiscard]] bool synchronized_output() const noexcept {
+      return options_.synchronized_output;
+    }
+
+    // Bytes handed to the sink that have not reached the terminal yet.
+    [[nodiscard]] std::size_t bytes_outstanding() const noexcept {
+      return sink_.bytes_outstanding();
+    }
+
+    // Frames dropped because the sink was congested.
+    [[nodiscard]] std::uint64_t frames_skipped() const noexcept {
+      return frames_skipped_;
+    }
+
+    // Hit/miss counters of the pre-encoded SGR cache.
+    [[nodiscard]] const SgrCache::Stats &sgr_cache_stats() const noexcept {
+      return sgr_cache_.stats();
+    }
+
+    // Stats of the most recent render()/render_pending() call.
+    [[nodiscard]] const RenderStats &last_stats() const noexcept {
+      return stats_;
+    }
+
+    // Recent calls, for p50/p99 aggregates.
+    [[nodiscard]] const RenderStatsWindow &stats_window() const noexcept {
+      return stats_window_;
+    }
+
   private:
+    void render_(const view::Frame &frame);
+    void finish_stats_(std::chrono::steady_clock::time_point start) noexcept;
     void reconcile_cursor(const view::Frame::CursorHint &hint);
+    void commit_();
+    bool try_scroll_(const glyph::core::Buffer &cur);
+    void full_redraw_(const glyph::core::Buffer     &cur,
+                      const view::Frame::CursorHint &hint);
+    bool hold_resize_(const view::Frame &frame);
+    void keep_skipped_(const view::Frame &frame);
+    void emit_changes_(const glyph::core::Buffer     &cur,
+                       const view::Frame::CursorHint &hint);
+    std::size_t emit_budgeted_(glyph::core::ConstBufferView cur);
+    void apply_style_(const glyph::core::Style &s);
+    void set_default_pen_() noexcept;
+    void store_span_(const glyph::core::Buffer &cur,
+                     glyph::core::DiffSpan      span);
+    [[nodiscard]] glyph::core::line_hash_t
+    blank_row_hash_(glyph::core::coord_t w);
+    void clear_styles_() noexcept;
+    bool adopt_clusters_(const glyph::core::Buffer &cur);
+    void prune_clusters_();
+    void reset_pen_();
+    void apply_cursor_(const view::Frame::CursorHint &hint);
+    void render_span_(glyph::core::ConstBufferView buf,
+                      glyph::core::DiffSpan        span);
+    void move_to_(glyph::core::ConstBufferView buf,
+                  glyph::core::coord_t         y,
+                  glyph::core::coord_t         x);
+    void emit_cells_(glyph::core::ConstBufferView buf,
+                     glyph::core::coord_t         y,
+                     glyph::core::coord_t         x0,
+                     glyph::core::coord_t         x1);
+    bool try_erase_(glyph::core::ConstBufferView buf,
+                    glyph::core::coord_t         y,
+                    glyph::core::coord_t         x,
+                    glyph::core::coord_t         x1,
+                    glyph::core::coord_t        &run);
+    [[nodiscard]] std::size_t reprint_cost_(glyph::core::ConstBufferView buf,
+                                            glyph::core::coord_t         y,
+                                            glyph::core::coord_t         x0,
+                                            glyph::core::coord_t         x1,
+                                            std::size_t limit) const;
+
+    std::unique_ptr<OstreamSink> owned_sink_{};
+    OutputSink                  &sink_;
+    OutputBuffer                 out_{};
+    AnsiRendererOptions          options_{};
 
-    std::ostream       &out_;
+    // Shadow of the terminal, cell for cell, diffed against frames as raw
+    // memory (see row_compare.h).
     glyph::core::Buffer prev_{};
     bool                has_prev_ = false;
+    // prev_'s cluster pool keeps every tag it may show (see
+    // adopt_clusters_); pruned through spare_clusters_ once it outgrows
+    // prune_at_.
+    glyph::core::ClusterPool spare_clusters_{};
+    std::size_t              prune_at_ = 0;
+    // Styles interned to key the SGR cache on one integer per pen.
+    glyph::core::StyleTable styles_{};
+    // Hash of every prev_ row, taken from the frame it was stored from, so
+    // spotting a changed row is one compare against Buffer::row_hash.
+    std::vector<glyph::core::line_hash_t> committed_hashes_{};
+    // Frames were skipped since the last render; dirty lines are unusable.
+    bool                stale_          = false;
+    std::uint64_t       frames_skipped_ = 0;
+
+    // Byte-budget / skipped-frame state: the frame being converged to, its
+    // cursor hint (held_cursor_) and the rows that still have unsent spans.
+    glyph::core::Buffer       target_{};
+    std::vector<std::uint8_t> carried_{};
+    std::vector<std::uint8_t> row_rank_{};
+    bool                      pending_ = false;
+    glyph::core::Rect         priority_{};
+
+    // Debounced resize: the newest frame waits in target_ until the size
+    // has been stable since resize_since_ for options_.resize_debounce.
+    bool                                  resize_held_ = false;
+    std::chrono::steady_clock::time_point resize_since_{};
+    view::Frame::CursorHint               held_cursor_{};
+
     view::Frame::CursorHint prev_cursor_{};
     bool                    has_prev_cursor_ = false;
+
+    // SGR state the terminal currently has. Frames end with the pen back at
+    // defaults; the renderer assumes nothing else changes it in between.
+    glyph::core::Style      pen_{};
+    glyph::core::style_id_t pen_id_    = glyph::core::StyleTable::kDefault;
+    bool                    pen_known_ = false;
+    SgrCache           sgr_cache_;
+
+    // Hardware cursor position as far as the renderer can tell. Only
+    // trusted within a frame; every frame starts from unknown().
+    CursorState cursor_{};
+
+    // Per-frame scratch, kept to reuse capacity. Rows carry the column
+    // window the frame wrote, so only that much of each row is diffed.
+    std::vector<glyph::core::DirtyRow> dirty_rows_{};
+    // dirty_rows_ merged with rows a budgeted frame carried; swapped in.
+    std::vector<glyph::core::DirtyRow> merged_rows_{};
+    std::vector<glyph::core::DirtyRow> changed_lines_{};
+    std::vector<glyph::core::DiffSpan> spans_{};
+    std::vector<glyph::core::line_hash_t> next_hashes_{};
+    std::vector<glyph::core::Cell>        blank_row_{};
+
+    RenderStats       stats_{};
+    RenderStatsWindow stats_window_{};
   };
 
 } // namespace glyph::render
@@ -0,0 +1,61 @@
+// glyph/render/ansi/cursor_motion.h
+//
+// Cursor motion planning for the ANSI renderer.
+//
+// Responsibilities:
+//   - Track what is known about the terminal cursor position.
+//   - Pick the cheapest escape sequence (in bytes) to reach a target cell:
+//     CUP, CHA, CUF/CUB, CUU/CUD, CR and CR+LF combinations.
+//
+// Re-printing unchanged cells is also a form of motion, but it depends on
+// buffer contents and pen state, so the renderer weighs that option itself
+// against cursor_move_cost().
+
+#pragma once
+
+#include "glyph/core/geometry.h"
+#include "glyph/render/output.h"
+
+#include <cstddef>
+
+namespace glyph::render {
+
+  // What the renderer knows about the hardware cursor. After printing into
+  // the last column (with autowrap off) the column is left unknown while
+  // the row stays known; CR recovers the column cheaply.
+  struct CursorState final {
+    core::Point pos{};
+    bool        row_known = false;
+    bool        col_known = false;
+
+    [[nodiscard]] constexpr bool known() const noexcept {
+      return row_known && col_known;
+    }
+
+    [[nodiscard]] constexpr bool at(core::Point p) const noexcept {
+      return known() && pos == p;
+    }
+
+    static constexpr CursorState unknown() noexcept {
+      return CursorState{};
+    }
+
+    static constexpr CursorState known_at(core::Point p) noexcept {
+      return CursorState{p, true, true};
+    }
+  };
+
+  // Byte cost of the cheapest move from `from` to `to` (0 when already
+  // there).
+  [[nodiscard]] std::size_t cursor_move_cost(const CursorState &from,
+                                             core::Point        to) noexcept;
+
+  // Emit the cheapest move from `from` to `to`.
+  void encode_cursor_move(OutputBuffer      &out,
+                          const CursorState &from,
+                          core::Point        to);
+
+  // Emit an absolute move (CUP) regardless of the current state.
+  void encode_cursor_position(OutputBuffer &out, core::Point to);
+
+} // namespace glyph::render
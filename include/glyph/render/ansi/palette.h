@@ -0,0 +1,47 @@
+// glyph/render/ansi/palette.h
+//
+// Color depth handling for the ANSI renderer.
+//
+// Responsibilities:
+//   - Define the color depth a terminal is driven with (ColorMode).
+//   - Map 0xRRGGBB onto the xterm 256-color and 16-color palettes using
+//     precomputed lookup tables (no per-cell palette search).
+//   - Recognise colors that exactly match a palette entry, so the shorter
+//     palette codes can be emitted even in true-color mode.
+
+#pragma once
+
+#include <cstdint>
+
+namespace glyph::render {
+
+  // ------------------------------------------------------------
+  // ColorMode: how Style colors are encoded.
+  // ------------------------------------------------------------
+  enum class ColorMode : std::uint8_t {
+    TrueColor  = 0, // 38;2;r;g;b (palette codes for exact matches)
+    Palette256 = 1, // 38;5;n
+    Palette16  = 2, // 30-37 / 90-97
+    Mono       = 3, // no colors, attributes only
+  };
+
+  // The 16 base colors assumed for codes 30-37 / 90-97 (the VGA palette the
+  // named colors in core/color.h follow).
+  inline constexpr std::uint32_t kAnsiBasePalette[16] = {
+      0x000000, 0x800000, 0x008000, 0x808000, // black maroon green olive
+      0x000080, 0x800080, 0x008080, 0xC0C0C0, // navy purple teal silver
+      0x808080, 0xFF0000, 0x00FF00, 0xFFFF00, // gray red lime yellow
+      0x0000FF, 0xFF00FF, 0x00FFFF, 0xFFFFFF, // blue magenta cyan white
+  };
+
+  // Nearest entry of the xterm 6x6x6 cube or gray ramp (16..255).
+  [[nodiscard]] std::uint8_t nearest_palette_256(std::uint32_t rgb) noexcept;
+
+  // Nearest of the 16 base colors (0..15).
+  [[nodiscard]] std::uint8_t nearest_palette_16(std::uint32_t rgb) noexcept;
+
+  // Palette index (0..255) whose color equals `rgb` exactly, or -1. Base
+  // colors (0..15) win over identical cube entries.
+  [[nodiscard]] int exact_palette_index(std::uint32_t rgb) noexcept;
+
+} // namespace glyph::render
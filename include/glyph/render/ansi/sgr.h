@@ -0,0 +1,50 @@
+// glyph/render/ansi/sgr.h
+//
+// SGR (Select Graphic Rendition) encoding for core::Style.
+//
+// Responsibilities:
+//   - Encode a style as a self-contained "reset + set" sequence.
+//   - Encode the transition between the terminal's current pen and a target
+//     style using only the parameters that changed, falling back to
+//     "reset + set" whenever that is shorter.
+//   - Encode colors for the terminal's color depth (see palette.h).
+
+#pragma once
+
+#include "glyph/core/style.h"
+#include "glyph/render/ansi/palette.h"
+#include "glyph/render/output.h"
+
+namespace glyph::render {
+
+  // Emit a full SGR sequence: ESC[0 ... m. Default colors are implied by the
+  // reset and are not repeated.
+  void encode_sgr(OutputBuffer      &out,
+                  const core::Style &s,
+                  ColorMode          mode = ColorMode::TrueColor);
+
+  // Emit the shortest SGR sequence that turns pen `from` into `to`. Emits
+  // nothing when the two render identically in `mode`.
+  void encode_sgr_transition(OutputBuffer      &out,
+                             const core::Style &from,
+                             const core::Style &to,
+                             ColorMode          mode = ColorMode::TrueColor);
+
+  // Whether two styles produce the same terminal pen (colors flagged as
+  // default compare equal regardless of their stored rgb value).
+  [[nodiscard]] constexpr bool
+  same_pen(const core::Style &a, const core::Style &b) noexcept {
+    if (a.attrs != b.attrs)
+      return false;
+    if (a.fg_is_default() != b.fg_is_default())
+      return false;
+    if (!a.fg_is_default() && a.fg_rgb != b.fg_rgb)
+      return false;
+    if (a.bg_is_default() != b.bg_is_default())
+      return false;
+    if (!a.bg_is_default() && a.bg_rgb != b.bg_rgb)
+      return false;
+    return true;
+  }
+
+} // namespace glyph::render
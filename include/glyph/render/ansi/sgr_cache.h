@@ -0,0 +1,133 @@
+// glyph/render/ansi/sgr_cache.h
+//
+// Cache of pre-encoded SGR sequences.
+//
+// Responsibilities:
+//   - Map a pen transition (current pen -> target style) to the bytes
+//     encode_sgr_transition / encode_sgr would produce, so repeated style
+//     switches become a lookup plus a copy.
+//   - Stay bounded: a fixed open-addressed table, no allocation after
+//     construction, old entries overwritten when a probe run is full.
+//   - Count hits and misses so the hit rate can be observed.
+//
+// Entries are keyed either by canonical pens or by StyleTable ids. Id keys
+// are one integer compare per probe, but only mean something together with
+// the table they came from: clear() the cache whenever that table is
+// cleared.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "glyph/core/style.h"
+#include "glyph/core/style_table.h"
+#include "glyph/render/ansi/palette.h"
+#include "glyph/render/output.h"
+
+namespace glyph::render {
+
+  // ------------------------------------------------------------
+  // SgrCache
+  // ------------------------------------------------------------
+  class SgrCache final {
+  public:
+    struct Stats final {
+      std::uint64_t hits   = 0;
+      std::uint64_t misses = 0;
+    };
+
+    static constexpr std::size_t kSlots    = 256; // power of two
+    static constexpr std::size_t kMaxProbe = 8;
+
+    explicit SgrCache(ColorMode mode = ColorMode::TrueColor);
+
+    // Same output as encode_sgr_transition(out, from, to, mode()).
+    void encode_transition(OutputBuffer      &out,
+                           const core::Style &from,
+                           const core::Style &to);
+
+    // Same output as encode_sgr(out, s, mode()).
+    void encode_full(OutputBuffer &out, const core::Style &s);
+
+    // Id-keyed forms of the above, for styles interned in `table`.
+    void encode_transition(OutputBuffer           &out,
+                           core::style_id_t        from,
+                           core::style_id_t        to,
+                           const core::StyleTable &table);
+    void encode_full(OutputBuffer           &out,
+                     core::style_id_t        s,
+                     const core::StyleTable &table);
+
+    // Entries depend on the color mode; changing it drops them.
+    void set_color_mode(ColorMode mode) noexcept;
+    [[nodiscard]] ColorMode mode() const noexcept {
+      return mode_;
+    }
+
+    void clear() noexcept;
+
+    [[nodiscard]] const Stats &stats() const noexcept {
+      return stats_;
+    }
+    void reset_stats() noexcept {
+      stats_ = {};
+    }
+
+  private:
+    // Canonical pen: rgb of default colors zeroed so equal pens share a key.
+    struct Pen final {
+      std::uint32_t fg    = 0;
+      std::uint32_t bg    = 0;
+      std::uint16_t attrs = 0;
+      std::uint16_t flags = 0;
+
+      friend constexpr bool operator==(Pen a, Pen b) noexcept {
+        return a.fg == b.fg && a.bg == b.bg && a.attrs == b.attrs &&
+               a.flags == b.flags;
+      }
+    };
+
+    // Longest SGR we produce is ~50 bytes (reset, six attributes, two
+    // 24-bit colors).
+    static constexpr std::size_t kMaxBytes = 55;
+
+    enum class Kind : std::uint8_t {
+      Empty,
+      Full,         // full encoding of `to`
+      Transition,   // `from` -> `to`
+      IdFull,       // as Full, pens hold style ids in `fg`
+      IdTransition, // as Transition, pens hold style ids in `fg`
+    };
+
+    struct Key final {
+      Pen  from{};
+      Pen  to{};
+      Kind kind = Kind::Empty;
+
+      friend constexpr bool operator==(const Key &a, const Key &b) noexcept {
+        return a.kind == b.kind && a.to == b.to && a.from == b.from;
+      }
+    };
+
+    struct Slot final {
+      Key          key{};
+      std::uint8_t len = 0;
+      char         bytes[kMaxBytes];
+    };
+
+    static Pen canonical_(const core::Style &s) noexcept;
+    static std::size_t hash_(const Key &k) noexcept;
+
+    void lookup_(OutputBuffer      &out,
+                 const Key         &key,
+                 const core::Style *from,
+                 const core::Style &to);
+
+    std::unique_ptr<Slot[]> slots_;
+    ColorMode               mode_;
+    Stats                   stats_{};
+  };
+
+} // namespace glyph::render
@@ -0,0 +1,80 @@
+// glyph/render/async_renderer.h
+//
+// Asynchronous renderer: moves diffing, encoding and terminal writes off
+// the caller's thread.
+//
+// Responsibilities:
+//   - Accept finished frames from the app thread without blocking on IO.
+//   - Hand frames to a render thread through a triple buffer (back, ready,
+//     front); the app only ever copies into its own back slot and swaps
+//     pointers under a short lock.
+//   - Collapse frames published while the writer is busy into the newest
+//     one, merging dirty lines so no change is lost.
+//
+// The wrapped renderer is only ever touched by the render thread once the
+// AsyncRenderer exists; use post() to run work (e.g. reset()) on it.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "glyph/render/render.h"
+#include "glyph/view/frame.h"
+
+namespace glyph::render {
+
+  class AsyncRenderer final : public Renderer {
+  public:
+    struct Stats final {
+      std::uint64_t published = 0; // frames handed to render()
+      std::uint64_t rendered  = 0; // frames the inner renderer consumed
+      std::uint64_t collapsed = 0; // frames replaced before being rendered
+    };
+
+    explicit AsyncRenderer(Renderer &inner);
+
+    // Renders the last published frame (if any), then joins the thread.
+    ~AsyncRenderer() override;
+
+    // Publish a frame. Copies it into the back slot and clears its dirty
+    // lines, exactly as a synchronous render would consume them.
+    void render(const view::Frame &frame) override;
+
+    // Run `task` on the render thread before the next frame.
+    void post(std::function<void()> task);
+
+    // Block until every published frame and posted task has been handled.
+    void flush();
+
+    [[nodiscard]] Stats stats() const;
+
+  private:
+    void run_();
+
+    Renderer &inner_;
+
+    // Triple buffer. back_ belongs to the app thread, front_ to the render
+    // thread; ready_ is exchanged under mu_.
+    view::Frame  slots_[3]{};
+    view::Frame *back_  = &slots_[0];
+    view::Frame *ready_ = &slots_[1];
+    view::Frame *front_ = &slots_[2];
+
+    mutable std::mutex                 mu_;
+    std::condition_variable            wake_;
+    std::condition_variable            idle_;
+    std::vector<std::function<void()>> tasks_{};
+    bool                               fresh_ = false; // ready_ unconsumed
+    bool                               busy_  = false;
+    bool                               stop_  = false;
+    Stats                              stats_{};
+
+    std::thread thread_;
+  };
+
+} // namespace glyph::render
@@ -0,0 +1,112 @@
+// glyph/render/frame_pacer.h
+//
+// Frame pacing for the app loop.
+//
+// Responsibilities:
+//   - Coalesce every invalidation inside one frame interval into a single
+//     render, capped at a configurable frame rate.
+//   - Hold input-driven frames back by a small latency so bursts (paste,
+//     key repeat) land in one frame.
+//   - Let the loop sleep until the next frame is due, or fully while
+//     nothing is invalidated.
+//
+// Usage:
+//   FramePacer pacer{{.max_fps = 60}};
+//   for (;;) {
+//     if (handle_input()) pacer.request_frame();
+//     if (model_changed()) pacer.invalidate();
+//     if (pacer.frame_due()) { pacer.begin_frame(); app.render(build()); }
+//     pacer.wait(10ms); // bounded so input is still polled
+//   }
+//
+// invalidate() and request_frame() may be called from any thread; they
+// wake a waiting loop.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace glyph::render {
+
+  // ------------------------------------------------------------
+  // FramePacerOptions
+  // ------------------------------------------------------------
+  struct FramePacerOptions final {
+    // Upper bound on renders per second (<= 0: uncapped).
+    double max_fps = 60.0;
+
+    // Delay between an input-driven request and its frame.
+    std::chrono::microseconds input_latency{2000};
+  };
+
+  // ------------------------------------------------------------
+  // FramePacer
+  // ------------------------------------------------------------
+  class FramePacer final {
+  public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+    using duration   = clock::duration;
+
+    explicit FramePacer(FramePacerOptions options = {});
+
+    // State changed (model update, animation tick): render in the next
+    // frame slot.
+    void invalidate() {
+      invalidate(clock::now());
+    }
+    void invalidate(time_point now);
+
+    // Input changed the UI: render after the input latency, but never
+    // sooner than the frame cap allows.
+    void request_frame() {
+      request_frame(clock::now());
+    }
+    void request_frame(time_point now);
+
+    // Whether a frame is pending and its time has come.
+    [[nodiscard]] bool frame_due() const {
+      return frame_due(clock::now());
+    }
+    [[nodiscard]] bool frame_due(time_point now) const;
+
+    // Whether anything is invalidated (due or not).
+    [[nodiscard]] bool pending() const;
+
+    // When the pending frame is due (time_point::max() if none).
+    [[nodiscard]] time_point deadline() const;
+
+    // Mark the start of a render: clears the pending request and starts
+    // the next frame interval.
+    void begin_frame() {
+      begin_frame(clock::now());
+    }
+    void begin_frame(time_point now);
+
+    // Sleep until a frame is due, an invalidation arrives from another
+    // thread, or `max_wait` passes. Returns frame_due().
+    bool wait(duration max_wait = duration::max());
+
+    [[nodiscard]] std::uint64_t frames() const;
+    [[nodiscard]] std::uint64_t coalesced() const;
+
+  private:
+    void schedule_(time_point due);
+
+    FramePacerOptions options_{};
+    duration          interval_{};
+
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;
+    bool                    pending_   = false;
+    bool                    has_frame_ = false;
+    time_point              due_{};
+    time_point              last_frame_{};
+    std::uint64_t           frames_   = 0;
+    std::uint64_t           requests_ = 0;
+  };
+
+} // namespace glyph::render
@@ -0,0 +1,261 @@
+// glyph/render/output.h
+//
+// Byte output primitives shared by renderers.
+//
+// Responsibilities:
+//   - Own a reusable, growable byte arena that a frame is encoded into.
+//   - Provide allocation-free integer / UTF-8 formatting into the arena.
+//   - Abstract the final write (raw file descriptor or std::ostream).
+//   - Report backpressure: a non-blocking sink queues what the terminal
+//     could not take yet, so a renderer can skip frames instead of
+//     stalling on a slow link.
+//
+// The arena keeps its capacity across clear(), so once it has grown to the
+// size of a typical frame, steady-state encoding does not touch the heap.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace glyph::render {
+
+  // ------------------------------------------------------------
+  // OutputBuffer: growable byte arena
+  // ------------------------------------------------------------
+  class OutputBuffer final {
+  public:
+    OutputBuffer() = default;
+
+    OutputBuffer(const OutputBuffer &)            = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    OutputBuffer(OutputBuffer &&) noexcept            = default;
+    OutputBuffer &operator=(OutputBuffer &&) noexcept = default;
+
+    [[nodiscard]] const char *data() const noexcept {
+      return data_.get();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return size_;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept {
+      return capacity_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+      return size_ == 0;
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+      return std::string_view{data_.get(), size_};
+    }
+
+    // Drop contents, keep capacity.
+    void clear() noexcept {
+      size_ = 0;
+    }
+
+    void reserve(std::size_t n) {
+      if (n > capacity_) {
+        grow_(n);
+      }
+    }
+
+    void append(char c) {
+      if (size_ == capacity_) {
+        grow_(size_ + 1);
+      }
+      data_[size_++] = c;
+    }
+
+    void append(std::string_view s) {
+      if (s.empty())
+        return;
+      reserve(size_ + s.size());
+      std::memcpy(data_.get() + size_, s.data(), s.size());
+      size_ += s.size();
+    }
+
+    // Repeat a single byte n times.
+    void append(std::size_t n, char c) {
+      reserve(size_ + n);
+      std::memset(data_.get() + size_, c, n);
+      size_ += n;
+    }
+
+    // Decimal formatting without iostreams / locale.
+    void append_uint(std::uint32_t v) {
+      char  tmp[10];
+      char *end = tmp + sizeof(tmp);
+      char *p   = end;
+      do {
+        *--p = char('0' + v % 10u);
+        v /= 10u;
+      } while (v != 0);
+      append(std::string_view{p, std::size_t(end - p)});
+    }
+
+    // Encode a codepoint as UTF-8. Values beyond U+10FFFF become '?'.
+    void append_utf8(char32_t cp) {
+      reserve(size_ + 4);
+      char *p = data_.get() + size_;
+      if (cp < 0x80) {
+        p[0] = static_cast<char>(cp);
+        size_ += 1;
+      }
+      else if (cp < 0x800) {
+        p[0] = static_cast<char>(0xC0 | (cp >> 6));
+        p[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        size_ += 2;
+      }
+      else if (cp < 0x10000) {
+        p[0] = static_cast<char>(0xE0 | (cp >> 12));
+        p[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        p[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        size_ += 3;
+      }
+      else if (cp < 0x110000) {
+        p[0] = static_cast<char>(0xF0 | (cp >> 18));
+        p[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        p[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        p[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        size_ += 4;
+      }
+      else {
+        p[0] = '?';
+        size_ += 1;
+      }
+    }
+
+  private:
+    void grow_(std::size_t min_capacity);
+
+    std::unique_ptr<char[]> data_{};
+    std::size_t             size_     = 0;
+    std::size_t             capacity_ = 0;
+  };
+
+  // ------------------------------------------------------------
+  // OutputSink: where encoded bytes end up
+  // ------------------------------------------------------------
+  class OutputSink {
+  public:
+    virtual ~OutputSink() = default;
+
+    OutputSink()                              = default;
+    OutputSink(const OutputSink &)            = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+
+    // Write all bytes (blocking).
+    virtual void write(std::string_view bytes) = 0;
+
+    // Gather write. Backends that support vectored IO override this so
+    // static prefixes/suffixes need not be copied next to the payload.
+    virtual void write_parts(std::span<const std::string_view> parts) {
+      for (const auto part : parts) {
+        write(part);
+      }
+    }
+
+    virtual void flush() {
+    }
+
+    // Bytes accepted by write() but not yet delivered. Blocking sinks
+    // always report 0.
+    [[nodiscard]] virtual std::size_t bytes_outstanding() const noexcept {
+      return 0;
+    }
+  };
+
+  // Adapter for std::ostream (tests, string streams, std::cout).
+  class OstreamSink final : public OutputSink {
+  public:
+    explicit OstreamSink(std::ostream &out) noexcept;
+
+    void write(std::string_view bytes) override;
+    void flush() override;
+
+  private:
+    std::ostream &out_;
+  };
+
+  // Direct writes to a file descriptor (write/writev on POSIX, _write on
+  // Windows). Bypasses stdio buffering entirely; the caller should not mix
+  // it with buffered writes to the same descriptor.
+  class FdSink final : public OutputSink {
+  public:
+    explicit FdSink(int fd) noexcept;
+
+    void write(std::string_view bytes) override;
+    void write_parts(std::span<const std::string_view> parts) override;
+
+    [[nodiscard]] int fd() const noexcept {
+      return fd_;
+    }
+
+  private:
+    int fd_ = -1;
+  };
+
+  // File descriptor sink that never blocks (POSIX: O_NONBLOCK for the
+  // sink's lifetime). Bytes the descriptor does not take immediately are
+  // queued in order and retried on the next write() or flush(). A hard
+  // write error (anything but EAGAIN/EWOULDBLOCK) drops the queue and is
+  // kept in error(). On Windows console handles cannot be made
+  // non-blocking; writes block as in FdSink.
+  //
+  // O_NONBLOCK is a property of the open file description, not of the fd.
+  // On a terminal, stdin, stdout and std::cout usually share one, so while
+  // the sink lives other code reading or writing the terminal through it
+  // can get EAGAIN. To keep the flag to the sink, give it a description
+  // of its own, e.g. ::open("/dev/tty", O_WRONLY | O_NOCTTY).
+  class NonBlockingFdSink final : public OutputSink {
+  public:
+    explicit NonBlockingFdSink(int fd);
+    ~NonBlockingFdSink() override;
+
+    void write(std::string_view bytes) override;
+    void write_parts(std::span<const std::string_view> parts) override;
+
+    // Push queued bytes as far as the descriptor allows; never waits.
+    void flush() override;
+
+    [[nodiscard]] std::size_t bytes_outstanding() const noexcept override {
+      return pending_.size() - head_;
+    }
+
+    // Wait up to `timeout_ms` (-1: forever) for the queue to drain.
+    // Returns true when nothing is outstanding.
+    bool drain(int timeout_ms = -1);
+
+    // errno of the last hard write error, 0 if none. Bytes queued at that
+    // point were dropped.
+    [[nodiscard]] int error() const noexcept {
+      return error_;
+    }
+
+    [[nodiscard]] int fd() const noexcept {
+      return fd_;
+    }
+
+  private:
+    // Write directly; returns the number of bytes taken (may be short).
+    std::size_t write_some_(std::string_view bytes);
+
+    int         fd_        = -1;
+    int         old_flags_ = -1;
+    int         error_     = 0;
+    std::string pending_{};
+    std::size_t head_ = 0; // first undelivered byte in pending_
+  };
+
+} // namespace glyph::render
@@ -0,0 +1,108 @@
+// glyph/render/render_stats.h
+//
+// Per-frame renderer statistics and rolling aggregates.
+//
+// Responsibilities:
+//   - Describe what one render call did (work counts, bytes, stage times).
+//   - Keep a bounded window of recent frames and report percentiles over
+//     it, for metrics export and regression alarms.
+//
+// Plain data; renderers fill a RenderStats per call and push it into a
+// RenderStatsWindow. Nothing here allocates after construction.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace glyph::render {
+
+  // ------------------------------------------------------------
+  // RenderStats: one render call
+  // ------------------------------------------------------------
+  struct RenderStats final {
+    std::uint32_t dirty_lines   = 0; // candidate rows reported by the frame
+    std::uint32_t changed_lines = 0; // rows left after hash filtering
+    std::uint32_t spans         = 0; // spans encoded
+    std::uint64_t cells         = 0; // cells printed or erased
+    std::uint32_t sgr_changes   = 0; // SGR sequences emitted
+    std::uint32_t cursor_moves  = 0; // cursor sequences emitted
+    std::uint64_t bytes         = 0; // bytes handed to the sink
+
+    bool full_redraw = false;
+    bool skipped     = false; // dropped under output backpressure
+
+    // Wall time per stage, in nanoseconds.
+    std::uint64_t dirty_ns  = 0; // dirty-line collection
+    std::uint64_t hash_ns   = 0; // unchanged-row filter, scroll detection
+    std::uint64_t diff_ns   = 0; // span diffing
+    std::uint64_t encode_ns = 0; // escape/glyph encoding
+    std::uint64_t write_ns  = 0; // sink write + flush
+
+    [[nodiscard]] constexpr std::uint64_t total_ns() const noexcept {
+      return dirty_ns + hash_ns + diff_ns + encode_ns + write_ns;
+    }
+  };
+
+  // Fields RenderStatsWindow can aggregate.
+  enum class RenderMetric : std::uint8_t {
+    DirtyLines,
+    ChangedLines,
+    Spans,
+    Cells,
+    SgrChanges,
+    CursorMoves,
+    Bytes,
+    DirtyNs,
+    HashNs,
+    DiffNs,
+    EncodeNs,
+    WriteNs,
+    TotalNs,
+  };
+
+  [[nodiscard]] std::uint64_t metric_value(const RenderStats &s,
+                                           RenderMetric       m) noexcept;
+
+  // ------------------------------------------------------------
+  // RenderStatsWindow: ring buffer of recent frames
+  // ------------------------------------------------------------
+  class RenderStatsWindow final {
+  public:
+    struct Summary final {
+      std::uint64_t p50 = 0;
+      std::uint64_t p99 = 0;
+      std::uint64_t max = 0;
+    };
+
+    explicit RenderStatsWindow(std::size_t capacity = 256);
+
+    void push(const RenderStats &s) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return count_;
+    }
+    [[nodiscard]] std::size_t capacity() const noexcept {
+      return capacity_;
+    }
+    // Frames pushed since construction / clear(), including evicted ones.
+    [[nodiscard]] std::uint64_t total_frames() const noexcept {
+      return total_;
+    }
+
+    // Percentiles (nearest rank) of `m` over the frames in the window.
+    // Not reentrant: uses an internal scratch buffer.
+    [[nodiscard]] Summary summarize(RenderMetric m) const noexcept;
+
+  private:
+    std::unique_ptr<RenderStats[]>   ring_;
+    std::unique_ptr<std::uint64_t[]> scratch_;
+    std::size_t                      capacity_ = 0;
+    std::size_t                      head_     = 0; // next write slot
+    std::size_t                      count_    = 0;
+    std::uint64_t                    total_    = 0;
+  };
+
+} // namespace glyph::render
@@ -5,18 +5,22 @@
 // Responsibilities:
 //   - Query current terminal size in character cells.
 //   - Toggle alternate screen + cursor visibility with RAII.
-//   - Provide a lightweight app wrapper for size + render.
+//   - Provide a lightweight app wrapper for size + render, including a
+//     recycled frame for render loops (begin_frame / end_frame).
+//   - Probe for synchronized output (mode 2026) and enable it on the
+//     renderer once the terminal confirms support.
 
 #pragma once
 
+#include "glyph/core/event.h"
 #include "glyph/core/geometry.h"
 #include "glyph/core/types.h"
 #include "glyph/render/ansi/ansi_renderer.h"
+#include "glyph/render/async_renderer.h"
+#include "glyph/view/frame.h"
+#include <atomic>
 #include <iosfwd>
-
-namespace glyph::view {
-  class Frame;
-}
+#include <memory>
 
 namespace glyph::render {
 
@@ -46,8 +50,26 @@ namespace glyph::render {
   struct TerminalSessionOptions final {
     bool use_alt_screen = true;
     bool hide_cursor    = true;
+
+    // Send a DECRQM query for mode 2026 on enter. Frames are bracketed in
+    // synchronized updates once the reply (a core::ModeReportEvent from the
+    // input backend) is passed to TerminalApp::handle_event. Put the input
+    // in raw mode first, or a cooked terminal echoes the reply.
+    bool synchronized_output = false;
+
+    // Diff, encode and write frames on a dedicated render thread so a
+    // stalled terminal never blocks the caller (see AsyncRenderer).
+    bool async_render = false;
+
+    // Options for the app's AnsiRenderer. With byte_budget or
+    // resize_debounce set, see TerminalApp::render_pending().
+    AnsiRendererOptions renderer{};
   };
 
+  // DECRQM query for the synchronized-output mode.
+  inline constexpr const char *kQuerySynchronizedOutput = "\x1b[?2026$p";
+  inline constexpr std::uint16_t kModeSynchronizedOutput = 2026;
+
   // ------------------------------------------------------------
   // TerminalSession
   // ------------------------------------------------------------
@@ -81,9 +103,68 @@ namespace glyph::render {
     void render(const view::Frame &frame);
     void reset_renderer();
 
+    // Frame recycling for render loops. begin_frame() hands out the app's
+    // own frame, sized to the terminal (or `size`) and reset to `fill`;
+    // end_frame() renders it. At a steady size only the rows the previous
+    // frame wrote are cleared, and nothing is allocated in the frame layer.
+    // The reference stays valid until the app is destroyed.
+    view::Frame &begin_frame(const core::Cell &fill = core::Cell{});
+    view::Frame &begin_frame(core::Size size,
+                             const core::Cell &fill = core::Cell{});
+    void end_frame();
+
+    // Work the renderer still owes the terminal: queued bytes, the rest of
+    // a frame the byte budget cut short, a frame skipped while the sink was
+    // congested, or a frame held by resize_debounce. Nothing draws it by
+    // itself, so an app that renders only on input should keep calling
+    // render_pending() while has_pending() is true (e.g. bound its input
+    // wait by it); otherwise the screen can stay cleared or stale. With
+    // async_render the work runs on the render thread, at most one call
+    // queued at a time, and has_pending() reports the state it last saw.
+    [[nodiscard]] bool has_pending() const noexcept;
+    bool render_pending();
+
+    // Consume terminal replies addressed to the app (mode reports). Returns
+    // true when the event was handled and should not reach the UI.
+    bool handle_event(const core::Event &ev);
+
+    [[nodiscard]] bool synchronized_output() const noexcept {
+      return synchronized_output_;
+    }
+
+    // Wait until everything published so far has reached the terminal
+    // (no-op without async_render).
+    void flush();
+
   private:
-    TerminalSession session_;
-    AnsiRenderer    renderer_;
+    // What AsyncRenderer drives: renders into renderer_ on the render
+    // thread and notes whether work is left over, for has_pending().
+    class TrackedRenderer_ final : public Renderer {
+    public:
+      explicit TrackedRenderer_(TerminalApp &app) noexcept : app_(app) {
+      }
+      void render(const view::Frame &frame) override;
+
+    private:
+      TerminalApp &app_;
+    };
+
+    // Run `fn` against the renderer on the thread that owns it.
+    template <class Fn> void with_renderer_(Fn &&fn);
+
+    TerminalSession        session_;
+    AnsiRenderer           renderer_;
+    TerminalSessionOptions options_{};
+    bool                   synchronized_output_ = false;
+    view::Frame            frame_{};
+    // renderer_.has_pending() as of the render thread's last call.
+    std::atomic<bool> pending_{false};
+    // A render_pending() task is queued on the render thread.
+    std::atomic<bool> posted_{false};
+    TrackedRenderer_  tracked_{*this};
+    // Declared last: the render thread stops before the renderer and the
+    // session are torn down.
+    std::unique_ptr<AsyncRenderer> async_{};
   };
 
 } // namespace glyph::render
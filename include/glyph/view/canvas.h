@@ -48,29 +48,20 @@ namespace glyph::view {
       view_.put(p, c);
     }
 
+    // Store a grapheme cluster in the owning frame; returns the Cell::ch
+    // value (see core::ClusterPool::intern).
+    char32_t intern_cluster(std::u32string_view cps) {
+      return view_.intern_cluster(cps);
+    }
+
     // Fill entire canvas.
     void fill(const cell_type &c) noexcept {
-      if (view_.empty())
-        return;
-
-      for (core::coord_t y = 0; y < view_.size.h; ++y) {
-        for (core::coord_t x = 0; x < view_.size.w; ++x) {
-          view_.at(x, y) = c;
-        }
-      }
+      view_.clear(c);
     }
 
     // Fill a rectangle in local canvas coordinate.
     void fill_rect(core::Rect r, const cell_type &c) noexcept {
-      auto sub = view_.subview(r);
-      if (sub.empty())
-        return;
-
-      for (core::coord_t y = 0; y < sub.size.h; ++y) {
-        for (core::coord_t x = 0; x < sub.size.w; ++x) {
-          sub.at(x, y) = c;
-        }
-      }
+      view_.fill_rect(r, c);
     }
 
   private:
@@ -34,6 +34,27 @@ namespace glyph::view {
       }
     }
 
+    // Recycle the frame for another pass: every cell becomes `c` and the
+    // cursor hint is dropped. If `c` is the last fill, only the rows
+    // written since then are rewritten, so a frame reused at one size
+    // costs what the previous pass drew and allocates nothing.
+    void reset(const cell_type &c = cell_type{}) noexcept {
+      if (c == fill_) {
+        buf_.clear_written(c);
+      }
+      else {
+        fill(c);
+      }
+      cursor_ = CursorHint{};
+    }
+
+    // Change size; every cell becomes `c` and the cursor hint is dropped.
+    void resize(core::Size s, const cell_type &c = cell_type{}) {
+      buf_.resize(s, c);
+      fill(c);
+      cursor_ = CursorHint{};
+    }
+
     [[nodiscard]] core::Size size() const noexcept {
       return buf_.size();
     }
@@ -74,9 +95,10 @@ namespace glyph::view {
       return buf_.const_view();
     }
 
-    // Fill whole frame.
+    // Fill whole frame. This also releases the frame's grapheme clusters.
     void fill(const cell_type &c) noexcept {
-      buf_.view().clear(c);
+      buf_.clear(c);
+      fill_ = c;
     }
 
     // Fill a rect with clipping.
@@ -84,6 +106,12 @@ namespace glyph::view {
       buf_.view().fill_rect(r, c);
     }
 
+    // Store a grapheme cluster for this frame; returns the Cell::ch value
+    // (see core::ClusterPool::intern).
+    char32_t intern_cluster(std::u32string_view cps) {
+      return buf_.clusters().intern(cps);
+    }
+
     // Subview (clipped). Returned view may be empty.
     [[nodiscard]] buffer_view_type subview(core::Rect r) noexcept {
       return buf_.view().subview(r);
@@ -103,6 +131,38 @@ namespace glyph::view {
       return buf_.take_dirty_lines();
     }
 
+    // Dirty rows with the column windows written since the last take,
+    // into a reusable buffer.
+    std::span<const core::DirtyRow>
+    take_dirty_into(std::vector<core::DirtyRow> &out) const {
+      return buf_.take_dirty_into(out);
+    }
+
+    // Drop the dirty lines without collecting them (no allocation).
+    void clear_dirty_lines() const noexcept {
+      buf_.clear_dirty_lines();
+    }
+
+    // O(1): whether anything was written since the last take.
+    [[nodiscard]] bool has_dirty_lines() const noexcept {
+      return buf_.has_dirty_lines();
+    }
+
+    // Cached hash of row y (see core::Buffer::row_hash).
+    [[nodiscard]] core::line_hash_t row_hash(core::coord_t y) const noexcept {
+      return buf_.row_hash(y);
+    }
+
+    [[nodiscard]] const buffer_type &buffer() const noexcept {
+      return buf_;
+    }
+
+    // Carry another frame's pending dirty lines over into this one (used
+    // when a frame replaces one that was never rendered).
+    void merge_dirty_lines(const Frame &other) noexcept {
+      buf_.merge_dirty_lines(other.buf_);
+    }
+
     // ----------------------------------------------------------
     // Cursor hint
     //
@@ -132,6 +192,7 @@ namespace glyph::view {
   private:
     buffer_type buf_{};
     CursorHint  cursor_{};
+    cell_type   fill_{}; // what unwritten rows hold (see reset)
   };
 
 } // namespace glyph::view
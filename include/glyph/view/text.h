@@ -4,6 +4,7 @@
 //
 // Responsibilities:
 //   - Draw ASCII/UTF-32 strings into a Frame with clipping.
+//   - Place UTF-32 text one grapheme cluster per cell (WidthPolicy::Grapheme).
 
 #pragma once
 
@@ -36,16 +37,21 @@ namespace glyph::view {
   }
 
   // ------------------------------------------------------------
-  // Draw UTF-32 text starting at p. Stops at frame width.
+  // Draw UTF-32 text starting at p, one grapheme cluster per cell. Stops
+  // at frame width.
   // ------------------------------------------------------------
   inline void draw_text(Frame &f, core::Point p, std::u32string_view text,
                         core::Cell cell = core::Cell::from_char(U' ')) {
     core::coord_t x = p.x;
-    for (char32_t ch : text) {
+    for (std::size_t i = 0; i < text.size();) {
       if (x >= f.size().w) {
         break;
       }
-      const core::coord_t w = core::coord_t(core::cell_width(ch));
+      const std::size_t end = core::next_grapheme(text, i);
+      const auto        g   = text.substr(i, end - i);
+      i                     = end;
+
+      const core::coord_t w = core::coord_t(core::cluster_width(g));
       if (w <= 0) {
         continue;
       }
@@ -53,7 +59,7 @@ namespace glyph::view {
         break;
       }
       core::Cell c = cell;
-      c.ch         = ch;
+      c.ch         = f.intern_cluster(g);
       c.width      = static_cast<std::uint8_t>(w);
       f.set(core::Point{x, p.y}, c);
       x = core::coord_t(x + w);
@@ -79,16 +85,21 @@ namespace glyph::view {
   }
 
   // ------------------------------------------------------------
-  // Draw UTF-32 text into a Canvas starting at p.
+  // Draw UTF-32 text into a Canvas starting at p, one grapheme cluster per
+  // cell.
   // ------------------------------------------------------------
   inline void draw_text(Canvas &c, core::Point p, std::u32string_view text,
                         core::Cell cell = core::Cell::from_char(U' ')) {
     core::coord_t x = p.x;
-    for (char32_t ch : text) {
+    for (std::size_t i = 0; i < text.size();) {
       if (x >= c.size().w) {
         break;
       }
-      const core::coord_t w = core::coord_t(core::cell_width(ch));
+      const std::size_t end = core::next_grapheme(text, i);
+      const auto        g   = text.substr(i, end - i);
+      i                     = end;
+
+      const core::coord_t w = core::coord_t(core::cluster_width(g));
       if (w <= 0) {
         continue;
       }
@@ -96,7 +107,7 @@ namespace glyph::view {
         break;
       }
       core::Cell out = cell;
-      out.ch         = ch;
+      out.ch         = c.intern_cluster(g);
       out.width      = static_cast<std::uint8_t>(w);
       c.set(core::Point{x, p.y}, out);
       x = core::coord_t(x + w);
@@ -138,7 +138,7 @@ int main() {
       continue;
     }
 
-    view::Frame frame{size, core::Cell::from_char(U' ')};
+    auto &frame = app.begin_frame(size, core::Cell::from_char(U' '));
     const auto render_time = std::chrono::steady_clock::now();
     const auto delta_us =
         std::chrono::duration_cast<std::chrono::microseconds>(
@@ -148,7 +148,7 @@ int main() {
         static_cast<std::uint64_t>(delta_us > 0 ? 1000000 / delta_us : 0);
     const auto phase = core::coord_t(frames % 7);
     render_frame(frame, polls, events, frames, fps, phase);
-    app.render(frame);
+    app.end_frame();
     last_render = render_time;
     ++frames;
   }
@@ -407,13 +407,12 @@ int main() {
       continue;
     }
 
-    view::Frame frame{core::Size{width, height}};
-    frame.fill(core::Cell(U' '));
+    auto &frame = app.begin_frame(core::Size{width, height}, core::Cell(U' '));
 
     if (width < 20 || height < 8) {
       view::draw_text(
           frame, {0, 0}, "Terminal too small for Snake.", core::Cell(U'!'));
-      app.render(frame);
+      app.end_frame();
       dirty = false;
       continue;
     }
@@ -421,7 +420,7 @@ int main() {
     if (grid.w < 5 || grid.h < 5) {
       view::draw_text(
           frame, {0, 0}, "Terminal too small for Snake.", core::Cell(U'!'));
-      app.render(frame);
+      app.end_frame();
       dirty       = false;
       initialized = false;
       continue;
@@ -446,7 +445,7 @@ int main() {
 
     layout.render(frame, frame.bounds());
 
-    app.render(frame);
+    app.end_frame();
     dirty = false;
   }
 
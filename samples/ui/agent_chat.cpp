@@ -18,6 +18,7 @@
 #include "glyph/core/style.h"
 #include "glyph/input/input_guard.h"
 #include "glyph/input/input.h"
+#include "glyph/render/frame_pacer.h"
 #include "glyph/render/terminal.h"
 #include "glyph/view/components/fill.h"
 #include "glyph/view/components/label.h"
@@ -334,10 +335,14 @@ int main() {
   using namespace glyph;
   using namespace std::chrono_literals;
 
-  render::TerminalApp app{std::cout};
+  // Raw input first, so the synchronized-output probe reply is not echoed.
   auto input_owner_ = glyph::input::make_default_input();
   auto &input = *input_owner_;
   input::InputGuard   guard(input, input::InputMode::Raw);
+  render::TerminalApp app{
+      std::cout, render::TerminalSessionOptions{
+                     .synchronized_output = true,
+                     .renderer = {.resize_debounce = 100ms}}};
 
   std::vector<Message> messages;
   messages.push_back(
@@ -357,8 +362,9 @@ int main() {
   int            response_idx = 0;
   int            spinner_phase = 0;
   bool           should_quit = false;
-  bool           needs_render = true;
   core::Size     last_size{};
+  render::FramePacer pacer{{.max_fps = 60}};
+  pacer.invalidate();
 
   auto last_tick = std::chrono::steady_clock::now();
 
@@ -372,7 +378,7 @@ int main() {
     }
 
     if (size != last_size) {
-      needs_render = true;
+      pacer.invalidate();
       last_size = size;
     }
 
@@ -380,6 +386,7 @@ int main() {
     for (;;) {
       auto ev = input.poll();
       if (std::holds_alternative<std::monostate>(ev)) break;
+      if (app.handle_event(ev)) continue;
 
       if (std::holds_alternative<core::KeyEvent>(ev)) {
         const auto &key = std::get<core::KeyEvent>(ev);
@@ -399,13 +406,13 @@ int main() {
           messages.push_back({Message::Assistant, U"", true});
           stream.start(resp);
           input_field.clear();
-          needs_render = true;
+          pacer.request_frame();
           continue;
         }
 
         // Delegate editing (insert / delete / caret motion) to the field.
         if (input_field.handle_key(key)) {
-          needs_render = true;
+          pacer.request_frame();
         }
       }
     }
@@ -425,19 +432,24 @@ int main() {
             messages.back().streaming = false;
           }
         }
-        needs_render = true;
+        pacer.invalidate();
       }
     }
 
-    // Render only when state changed.
-    if (needs_render) {
-      view::Frame frame{size};
+    // Render only when state changed, at most once per frame interval.
+    if (pacer.frame_due()) {
+      pacer.begin_frame();
+      auto &frame = app.begin_frame(size);
       render_ui(frame, messages, stream, spinner_phase, input_field);
-      app.render(frame);
-      needs_render = false;
+      app.end_frame();
+    }
+    // A window drag is drawn once the size has settled.
+    if (app.has_pending()) {
+      app.render_pending();
     }
 
-    std::this_thread::sleep_for(16ms);
+    // Sleep until a frame is due; bounded so input is still polled.
+    pacer.wait(16ms);
   }
 
   return 0;
@@ -0,0 +1,225 @@
+// glyph/core/row_compare.cpp
+//
+// SSE2/AVX2 row comparison kernels and runtime dispatch.
+//
+// Notes:
+//   - Rows are scanned as bytes; the first differing byte is located with
+//     movemask + count-trailing-zeros and mapped back to its cell.
+//   - The AVX2 kernel is compiled with a target attribute (GCC/Clang) so the
+//     rest of the library keeps the baseline ISA; it is only called after
+//     CPUID reports AVX2 and OS-enabled YMM state.
+
+#include "glyph/core/row_compare.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||           \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLYPH_ROW_COMPARE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(GLYPH_ROW_COMPARE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define GLYPH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GLYPH_TARGET_AVX2
+#endif
+
+namespace glyph::core {
+
+  static_assert(sizeof(Cell) == 20 && sizeof(Style) == 12,
+                "row_compare assumes Cell has no implicit padding");
+
+  namespace {
+
+    std::size_t mismatch_scalar(const unsigned char *a,
+                                const unsigned char *b,
+                                std::size_t          bytes) noexcept {
+      // Word-at-a-time first, then the tail byte by byte.
+      std::size_t i = 0;
+      for (; i + 8 <= bytes; i += 8) {
+        std::uint64_t wa = 0;
+        std::uint64_t wb = 0;
+        std::memcpy(&wa, a + i, 8);
+        std::memcpy(&wb, b + i, 8);
+        if (wa != wb)
+          break;
+      }
+      for (; i < bytes; ++i) {
+        if (a[i] != b[i])
+          return i;
+      }
+      return bytes;
+    }
+
+#if defined(GLYPH_ROW_COMPARE_X86)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned ctz32(std::uint32_t v) noexcept {
+      unsigned long idx = 0;
+      _BitScanForward(&idx, v);
+      return unsigned(idx);
+    }
+#else
+    unsigned ctz32(std::uint32_t v) noexcept {
+      return unsigned(__builtin_ctz(v));
+    }
+#endif
+
+    __m128i load128(const unsigned char *p) noexcept {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+
+    GLYPH_TARGET_AVX2
+    __m256i load256(const unsigned char *p) noexcept {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+
+    std::size_t mismatch_sse2(const unsigned char *a,
+                              const unsigned char *b,
+                              std::size_t          bytes) noexcept {
+      std::size_t i = 0;
+      for (; i + 16 <= bytes; i += 16) {
+        const auto eq = std::uint32_t(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(load128(a + i), load128(b + i))));
+        if (eq != 0xFFFFu)
+          return i + ctz32(~eq);
+      }
+      return i + mismatch_scalar(a + i, b + i, bytes - i);
+    }
+
+    GLYPH_TARGET_AVX2
+    std::size_t mismatch_avx2(const unsigned char *a,
+                              const unsigned char *b,
+                              std::size_t          bytes) noexcept {
+      std::size_t i = 0;
+      // Two vectors per iteration: one branch per 64 bytes on equal rows.
+      for (; i + 64 <= bytes; i += 64) {
+        const __m256i e0 = _mm256_cmpeq_epi8(load256(a + i), load256(b + i));
+        const __m256i e1 =
+            _mm256_cmpeq_epi8(load256(a + i + 32), load256(b + i + 32));
+        if (_mm256_movemask_epi8(_mm256_and_si256(e0, e1)) != -1) {
+          const auto m0 = std::uint32_t(_mm256_movemask_epi8(e0));
+          if (m0 != 0xFFFFFFFFu)
+            return i + ctz32(~m0);
+          const auto m1 = std::uint32_t(_mm256_movemask_epi8(e1));
+          return i + 32 + ctz32(~m1);
+        }
+      }
+      for (; i + 32 <= bytes; i += 32) {
+        const auto eq = std::uint32_t(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(load256(a + i), load256(b + i))));
+        if (eq != 0xFFFFFFFFu)
+          return i + ctz32(~eq);
+      }
+      return i + mismatch_scalar(a + i, b + i, bytes - i);
+    }
+
+    bool cpu_has_avx2() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+      int regs[4] = {};
+      __cpuid(regs, 0);
+      if (regs[0] < 7)
+        return false;
+      __cpuid(regs, 1);
+      const bool osxsave = (regs[2] & (1 << 27)) != 0;
+      const bool avx     = (regs[2] & (1 << 28)) != 0;
+      if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+      __cpuidex(regs, 7, 0);
+      return (regs[1] & (1 << 5)) != 0;
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif // GLYPH_ROW_COMPARE_X86
+
+    using MismatchFn = std::size_t (*)(const unsigned char *,
+                                       const unsigned char *,
+                                       std::size_t) noexcept;
+
+    MismatchFn kernel_for(RowCompareIsa isa) noexcept {
+      switch (isa) {
+#if defined(GLYPH_ROW_COMPARE_X86)
+      case RowCompareIsa::Avx2: return &mismatch_avx2;
+      case RowCompareIsa::Sse2: return &mismatch_sse2;
+#endif
+      default: return &mismatch_scalar;
+      }
+    }
+
+    RowCompareIsa detect_isa() noexcept {
+#if defined(GLYPH_ROW_COMPARE_X86)
+      return cpu_has_avx2() ? RowCompareIsa::Avx2 : RowCompareIsa::Sse2;
+#else
+      return RowCompareIsa::Scalar;
+#endif
+    }
+
+    struct Dispatch final {
+      RowCompareIsa isa;
+      MismatchFn    fn;
+    };
+
+    const Dispatch &dispatch() noexcept {
+      static const Dispatch d = [] {
+        const RowCompareIsa isa = detect_isa();
+        return Dispatch{isa, kernel_for(isa)};
+      }();
+      return d;
+    }
+
+    std::size_t first_mismatch_with_(MismatchFn  fn,
+                                     const Cell *a,
+                                     const Cell *b,
+                                     std::size_t n) noexcept {
+      const auto at = fn(reinterpret_cast<const unsigned char *>(a),
+                         reinterpret_cast<const unsigned char *>(b),
+                         n * sizeof(Cell));
+      return at / sizeof(Cell);
+    }
+
+  } // namespace
+
+  RowCompareIsa row_compare_isa() noexcept {
+    return dispatch().isa;
+  }
+
+  bool row_compare_supported(RowCompareIsa isa) noexcept {
+    return std::uint8_t(isa) <= std::uint8_t(row_compare_isa());
+  }
+
+  const char *to_string(RowCompareIsa isa) noexcept {
+    switch (isa) {
+    case RowCompareIsa::Scalar: return "scalar";
+    case RowCompareIsa::Sse2:   return "sse2";
+    case RowCompareIsa::Avx2:   return "avx2";
+    }
+    return "unknown";
+  }
+
+  std::size_t
+  first_mismatch(const Cell *a, const Cell *b, std::size_t n) noexcept {
+    return first_mismatch_with_(dispatch().fn, a, b, n);
+  }
+
+  std::size_t first_mismatch_bytes(const void *a,
+                                   const void *b,
+                                   std::size_t bytes) noexcept {
+    return dispatch().fn(static_cast<const unsigned char *>(a),
+                         static_cast<const unsigned char *>(b), bytes);
+  }
+
+  std::size_t first_mismatch(RowCompareIsa isa,
+                             const Cell   *a,
+                             const Cell   *b,
+                             std::size_t   n) noexcept {
+    return first_mismatch_with_(kernel_for(isa), a, b, n);
+  }
+
+} // namespace glyph::core
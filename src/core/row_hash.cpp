@@ -0,0 +1,168 @@
+// glyph/core/row_hash.cpp
+//
+// Row hash backends.
+//
+// Notes:
+//   - Wyhash: the wyhash construction (public domain) reduced to what rows
+//     need: fixed seed, 8-byte little-endian loads via memcpy, and three
+//     independent multiply chains per 48-byte step so the 128-bit
+//     multiplies overlap. Rows are sizeof(Cell) * width bytes, so the short
+//     input paths only matter for tiny widths.
+//   - Fnv1a: one multiply per byte; kept as the reference the faster
+//     backend is measured against.
+//   - GLYPH_ROW_HASH_FNV (set by CMake from GLYPH_ROW_HASH=fnv) makes
+//     Fnv1a the built-in backend.
+
+#include "glyph/core/row_hash.h"
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace glyph::core {
+
+  static_assert(std::has_unique_object_representations_v<Cell>,
+                "row hashing reads Cell bytes; Cell must have no padding");
+
+  namespace {
+
+    // ----------------------------------------------------------
+    // Wyhash
+    // ----------------------------------------------------------
+    constexpr std::uint64_t kWyP0 = 0xa0761d6478bd642full;
+    constexpr std::uint64_t kWyP1 = 0xe7037ed1a0b428dbull;
+    constexpr std::uint64_t kWyP2 = 0x8ebc6af09c88c6e3ull;
+    constexpr std::uint64_t kWyP3 = 0x589965cc75132761ull;
+
+    // 64x64 -> 128 multiply; a and b receive the low and high halves.
+    inline void mum(std::uint64_t &a, std::uint64_t &b) noexcept {
+#if defined(__SIZEOF_INT128__)
+      const __uint128_t r = __uint128_t(a) * b;
+      a                   = std::uint64_t(r);
+      b                   = std::uint64_t(r >> 64);
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+      a = _umul128(a, b, &b);
+#else
+      const std::uint64_t ha = a >> 32, hb = b >> 32;
+      const std::uint64_t la = std::uint32_t(a), lb = std::uint32_t(b);
+      const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la,
+                          rl = la * lb;
+      const std::uint64_t t  = rl + (rm0 << 32);
+      std::uint64_t       c  = t < rl;
+      const std::uint64_t lo = t + (rm1 << 32);
+      c += lo < t;
+      a = lo;
+      b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+      mum(a, b);
+      return a ^ b;
+    }
+
+    inline std::uint64_t r8(const unsigned char *p) noexcept {
+      std::uint64_t v;
+      std::memcpy(&v, p, sizeof v);
+      return v;
+    }
+
+    inline std::uint64_t r4(const unsigned char *p) noexcept {
+      std::uint32_t v;
+      std::memcpy(&v, p, sizeof v);
+      return v;
+    }
+
+    std::uint64_t wyhash(const unsigned char *p, std::size_t len) noexcept {
+      std::uint64_t seed = mix(kWyP0, kWyP1);
+      std::uint64_t a    = 0;
+      std::uint64_t b    = 0;
+      if (len <= 16) {
+        // Rows are whole cells (multiples of 4 bytes), so 1..3 never occurs.
+        if (len >= 4) {
+          const std::size_t mid = (len >> 3) << 2;
+          a = (r4(p) << 32) | r4(p + mid);
+          b = (r4(p + len - 4) << 32) | r4(p + len - 4 - mid);
+        }
+      }
+      else {
+        std::size_t i = len;
+        if (i > 48) {
+          std::uint64_t s1 = seed;
+          std::uint64_t s2 = seed;
+          do {
+            seed = mix(r8(p) ^ kWyP1, r8(p + 8) ^ seed);
+            s1   = mix(r8(p + 16) ^ kWyP2, r8(p + 24) ^ s1);
+            s2   = mix(r8(p + 32) ^ kWyP3, r8(p + 40) ^ s2);
+            p += 48;
+            i -= 48;
+          } while (i > 48);
+          seed ^= s1 ^ s2;
+        }
+        while (i > 16) {
+          seed = mix(r8(p) ^ kWyP1, r8(p + 8) ^ seed);
+          p += 16;
+          i -= 16;
+        }
+        a = r8(p + i - 16);
+        b = r8(p + i - 8);
+      }
+      a ^= kWyP1;
+      b ^= seed;
+      mum(a, b);
+      return mix(a ^ kWyP0 ^ len, b ^ kWyP1);
+    }
+
+    // ----------------------------------------------------------
+    // FNV-1a
+    // ----------------------------------------------------------
+    std::uint64_t fnv1a(const unsigned char *p, std::size_t len) noexcept {
+      std::uint64_t h = 1469598103934665603ull;
+      for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+      }
+      return h;
+    }
+
+  } // namespace
+
+  RowHash row_hash_kind() noexcept {
+#if defined(GLYPH_ROW_HASH_FNV)
+    return RowHash::Fnv1a;
+#else
+    return RowHash::Wyhash;
+#endif
+  }
+
+  const char *to_string(RowHash kind) noexcept {
+    switch (kind) {
+    case RowHash::Wyhash: return "wyhash";
+    case RowHash::Fnv1a: return "fnv1a";
+    }
+    return "?";
+  }
+
+  line_hash_t hash_cells(const Cell *cells, std::size_t n) noexcept {
+    const auto *p = reinterpret_cast<const unsigned char *>(cells);
+#if defined(GLYPH_ROW_HASH_FNV)
+    return fnv1a(p, n * sizeof(Cell));
+#else
+    return wyhash(p, n * sizeof(Cell));
+#endif
+  }
+
+  line_hash_t hash_cells(RowHash kind, const Cell *cells,
+                         std::size_t n) noexcept {
+    const auto *p = reinterpret_cast<const unsigned char *>(cells);
+    switch (kind) {
+    case RowHash::Fnv1a: return fnv1a(p, n * sizeof(Cell));
+    case RowHash::Wyhash: break;
+    }
+    return wyhash(p, n * sizeof(Cell));
+  }
+
+} // namespace glyph::core
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <string_view>
 
 namespace glyph::input::detail {
 
@@ -203,6 +204,42 @@ namespace glyph::input::detail {
     }
   }
 
+  // DECRPM: CSI [?] mode ; value $ y (params_ holds everything before 'y').
+  void VtDecoder::finish_mode_report() {
+    std::u32string_view p{params_};
+    core::ModeReportEvent ev{};
+    ev.dec_private = !p.empty() && p.front() == U'?';
+    if (ev.dec_private)
+      p.remove_prefix(1);
+    if (p.empty() || p.back() != U'$')
+      return;
+    p.remove_suffix(1);
+
+    int  values[2] = {0, 0};
+    int  idx       = 0;
+    bool has_digit = false;
+    for (char32_t ch : p) {
+      if (ch >= U'0' && ch <= U'9') {
+        if (values[idx] < 100000)
+          values[idx] = values[idx] * 10 + int(ch - U'0');
+        has_digit = true;
+      }
+      else if (ch == U';' && idx == 0 && has_digit) {
+        idx       = 1;
+        has_digit = false;
+      }
+      else {
+        return;
+      }
+    }
+    if (idx != 1 || !has_digit || values[0] > 0xFFFF || values[1] > 4)
+      return;
+
+    ev.mode  = std::uint16_t(values[0]);
+    ev.state = core::ModeState(values[1]);
+    pending_.push_back(ev);
+  }
+
   void VtDecoder::step_csi(char32_t ch) {
     // --- SGR mouse payload (entered after '<') ---
     if (mouse_sgr_) {
@@ -263,6 +300,24 @@ namespace glyph::input::detail {
       params_.push_back(ch);
       return;
     }
+    // Private marker and intermediate of terminal replies (DECRPM).
+    if ((ch == U'?' && params_.empty()) || ch == U'$') {
+      params_.push_back(ch);
+      return;
+    }
+    if (ch == U'y') {
+      finish_mode_report();
+      state_ = State::Ground;
+      params_.clear();
+      return;
+    }
+    if (!params_.empty() &&
+        (params_.front() == U'?' || params_.back() == U'$')) {
+      // Unhandled reply: swallow it rather than misread it as a key.
+      state_ = State::Ground;
+      params_.clear();
+      return;
+    }
 
     switch (ch) {
     case U'A': emit_key(core::KeyCode::Up, core::Mod::None); break;
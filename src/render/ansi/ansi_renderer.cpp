@@ -4,293 +4,894 @@
 //
 // Notes:
 //   - Full redraw on first frame or size change.
-//   - Incremental updates via diff spans on dirty lines.
-//   - Styles emitted as SGR only when they change.
+//   - Incremental updates via diff spans on dirty lines; only the sent
+//     spans are copied into the shadow.
+//   - Cursor moves between spans are planned by byte cost (see
+//     cursor_motion.h); short unchanged gaps are re-printed instead. The
+//     first move of a frame is absolute.
+//   - Vertically shifted row blocks are moved with a scroll region
+//     (DECSTBM + SU/SD) and only the exposed rows are repainted.
+//   - Styles emitted as SGR only when they change, as a delta against the
+//     tracked terminal pen (see sgr.h).
+//   - Cluster cells are diffed by tag. The shadow's pool adopts each
+//     frame's tags; one that comes back naming other bytes forces a full
+//     redraw, so a reused tag never leaves a stale cluster on screen.
+//   - Everything is encoded into the byte arena (out_) and written once.
+//   - Each call fills a RenderStats; encode time is what is left of the
+//     call after the separately timed stages.
 
 #include "glyph/render/ansi/ansi_renderer.h"
 
 #include "glyph/core/diff.h"
+#include "glyph/render/ansi/cursor_motion.h"
+#include "glyph/render/ansi/sgr.h"
 #include "glyph/view/frame.h"
-#include <ostream>
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <string_view>
 
 namespace glyph::render {
 
-  AnsiRenderer::AnsiRenderer(std::ostream &out) noexcept : out_(out) {
+  // Smallest number of saved row repaints worth a scroll region.
+  constexpr glyph::core::coord_t kScrollMinRows = 3;
+
+  // Shadow cluster pool size below which pruning is not worth a scan.
+  constexpr std::size_t kClusterPruneMin = 1024;
+
+  using StatsClock = std::chrono::steady_clock;
+
+  static std::uint64_t elapsed_ns(StatsClock::time_point since) noexcept {
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             StatsClock::now() - since)
+                             .count());
+  }
+
+  AnsiRenderer::AnsiRenderer(std::ostream &out, AnsiRendererOptions options)
+      : owned_sink_(std::make_unique<OstreamSink>(out)), sink_(*owned_sink_),
+        options_(options), sgr_cache_(options.color_mode) {
+  }
+
+  AnsiRenderer::AnsiRenderer(OutputSink         &sink,
+                             AnsiRendererOptions options)
+      : sink_(sink), options_(options), sgr_cache_(options.color_mode) {
   }
 
   void AnsiRenderer::reset() noexcept {
     prev_.resize(core::Size{0, 0});
     has_prev_        = false;
     has_prev_cursor_ = false;
+    stale_           = false;
+    pending_         = false;
+    resize_held_     = false;
+    pen_known_       = false;
+    cursor_          = CursorState::unknown();
   }
 
-  // Clear the entire screen.
-  static void ansi_clear(std::ostream &out) {
-    out << "\x1b[2J";
-  }
-
-  // Move the cursor to home (1,1).
-  static void ansi_home(std::ostream &out) {
-    out << "\x1b[H";
+  void AnsiRenderer::set_color_mode(ColorMode mode) noexcept {
+    if (options_.color_mode == mode)
+      return;
+    options_.color_mode = mode;
+    sgr_cache_.set_color_mode(mode);
+    reset();
   }
 
   // Reset all SGR attributes.
-  static void ansi_reset(std::ostream &out) {
-    out << "\x1b[0m";
-  }
-
-  // Move cursor to zero-based row/col.
-  static void ansi_move(
-      std::ostream &out, glyph::core::coord_t row, glyph::core::coord_t col) {
-    out << "\x1b[" << (row + 1) << ";" << (col + 1) << "H";
+  static void ansi_reset(OutputBuffer &out) {
+    out.append("\x1b[0m");
   }
 
   // Enable/disable terminal line wrapping.
-  static void ansi_wrap(std::ostream &out, bool enable) {
-    out << (enable ? "\x1b[?7h" : "\x1b[?7l");
+  static void ansi_wrap(OutputBuffer &out, bool enable) {
+    out.append(enable ? "\x1b[?7h" : "\x1b[?7l");
   }
 
   // Apply the frame's cursor hint to the hardware cursor. A visible hint
   // positions and shows the cursor (so an IME anchors its candidate window
   // correctly); otherwise the cursor stays hidden.
-  static void ansi_apply_cursor(std::ostream                    &out,
+  static void ansi_apply_cursor(OutputBuffer                  &out,
                                 const view::Frame::CursorHint &hint) {
     if (hint.visible) {
-      ansi_move(out, hint.pos.y, hint.pos.x);
-      out << "\x1b[?25h";
+      encode_cursor_position(out, hint.pos);
+      out.append("\x1b[?25h");
     } else {
-      out << "\x1b[?25l";
+      out.append("\x1b[?25l");
     }
   }
 
-  // Emit SGR for the given style (true-color + attributes).
-  static void ansi_apply_style(std::ostream &out, const glyph::core::Style &s) {
-    out << "\x1b[0";
+  // Encode a single cell glyph; NUL is drawn as a blank. Grapheme clusters
+  // are copied from the view's pool as stored (already UTF-8); a tag the
+  // pool does not know is drawn as U+FFFD.
+  static void emit_utf8(OutputBuffer                &out,
+                        glyph::core::ConstBufferView buf, char32_t cp) {
+    if (cp == 0) {
+      out.append(' ');
+      return;
+    }
+    if (glyph::core::is_cluster(cp)) {
+      const auto bytes =
+          buf.clusters ? buf.clusters->utf8(cp) : std::string_view{};
+      if (bytes.empty()) {
+        out.append_utf8(0xFFFD);
+      }
+      else {
+        out.append(bytes);
+      }
+      return;
+    }
+    out.append_utf8(cp);
+  }
 
-    if (s.attrs & glyph::core::Style::AttrBold) {
-      out << ";1";
+  void AnsiRenderer::apply_cursor_(const view::Frame::CursorHint &hint) {
+    ansi_apply_cursor(out_, hint);
+    if (hint.visible) {
+      ++stats_.cursor_moves;
+      cursor_ = CursorState::known_at(hint.pos);
     }
-    if (s.attrs & glyph::core::Style::AttrDim) {
-      out << ";2";
+  }
+
+  // Switch the terminal pen to `s`, emitting only what changed.
+  void AnsiRenderer::apply_style_(const glyph::core::Style &s) {
+    using glyph::core::StyleTable;
+    if (pen_known_ && same_pen(pen_, s))
+      return;
+
+    // Key the SGR cache on interned ids; fall back to the pens themselves
+    // if the table is full.
+    const auto id = styles_.intern(s);
+    if (id != StyleTable::kFull &&
+        (!pen_known_ || pen_id_ != StyleTable::kFull)) {
+      if (pen_known_) {
+        sgr_cache_.encode_transition(out_, pen_id_, id, styles_);
+      }
+      else {
+        sgr_cache_.encode_full(out_, id, styles_);
+      }
     }
-    if (s.attrs & glyph::core::Style::AttrItalic) {
-      out << ";3";
+    else if (pen_known_) {
+      sgr_cache_.encode_transition(out_, pen_, s);
     }
-    if (s.attrs & glyph::core::Style::AttrUnderline) {
-      out << ";4";
+    else {
+      sgr_cache_.encode_full(out_, s);
     }
-    if (s.attrs & glyph::core::Style::AttrBlink) {
-      out << ";5";
+    ++stats_.sgr_changes;
+    pen_       = s;
+    pen_id_    = id;
+    pen_known_ = true;
+  }
+
+  void AnsiRenderer::set_default_pen_() noexcept {
+    pen_       = glyph::core::Style{};
+    pen_id_    = glyph::core::StyleTable::kDefault;
+    pen_known_ = true;
+  }
+
+  // Copy one sent span into the shadow, cells as they are. The rest of a
+  // changed row already matches the frame (that is what diffing
+  // established), so once its spans are stored the row takes over the
+  // frame's row hash.
+  void AnsiRenderer::store_span_(const glyph::core::Buffer &cur,
+                                 glyph::core::DiffSpan      span) {
+    const auto  src   = cur.const_view();
+    const auto *first = &src.at(span.x0, span.y);
+    std::copy(first, first + (span.x1 - span.x0),
+              &prev_.view().at(span.x0, span.y));
+    committed_hashes_[std::size_t(span.y)] = cur.row_hash(span.y);
+  }
+
+  // Hash of a row of blank Cell{}s: what prev_ holds after a full redraw
+  // and in rows exposed by a scroll.
+  glyph::core::line_hash_t
+  AnsiRenderer::blank_row_hash_(glyph::core::coord_t w) {
+    blank_row_.assign(std::size_t(std::max<glyph::core::coord_t>(w, 0)),
+                      glyph::core::Cell{});
+    return glyph::core::hash_cells(blank_row_.data(), blank_row_.size());
+  }
+
+  // Give the shadow's pool the clusters of `cur` under cur's own tags, so
+  // diffing tags as plain values stays exact. False if a tag the shadow
+  // may still show now names different bytes.
+  bool AnsiRenderer::adopt_clusters_(const glyph::core::Buffer &cur) {
+    if (prev_.clusters().size() > std::max(kClusterPruneMin, prune_at_)) {
+      prune_clusters_();
     }
-    if (s.attrs & glyph::core::Style::AttrStrike) {
-      out << ";9";
+    return prev_.clusters().adopt_all(cur.clusters());
+  }
+
+  // Rebuild the shadow's pool from the tags it still shows, so clusters
+  // long gone from the screen do not pile up between full redraws.
+  void AnsiRenderer::prune_clusters_() {
+    spare_clusters_.clear();
+    const auto shadow = prev_.const_view();
+    for (glyph::core::coord_t y = 0; y < shadow.size.h; ++y) {
+      for (glyph::core::coord_t x = 0; x < shadow.size.w; ++x) {
+        const char32_t ch = shadow.at(x, y).ch;
+        if (glyph::core::is_cluster(ch)) {
+          (void)spare_clusters_.adopt(prev_.clusters(), ch);
+        }
+      }
     }
+    std::swap(prev_.clusters(), spare_clusters_);
+    prune_at_ = 2 * prev_.clusters().size();
+  }
 
-    if (s.fg_is_default()) {
-      out << ";39";
+  // Start the style table over. Ids only key the SGR cache (and pen_id_),
+  // so this is safe between any two frames.
+  void AnsiRenderer::clear_styles_() noexcept {
+    if (styles_.size() <= 1)
+      return;
+    styles_.clear();
+    sgr_cache_.clear();
+    if (!same_pen(pen_, glyph::core::Style{})) {
+      pen_known_ = false;
+    }
+    pen_id_ = glyph::core::StyleTable::kDefault;
+  }
+
+  // Return the pen to defaults at the end of a frame (if it is not already).
+  void AnsiRenderer::reset_pen_() {
+    if (pen_known_ && same_pen(pen_, glyph::core::Style{}))
+      return;
+    ansi_reset(out_);
+    ++stats_.sgr_changes;
+    set_default_pen_();
+  }
+
+  // A cell that erasing reproduces: a blank whose look depends only on the
+  // background (underline and strike would draw on a space).
+  static bool erasable_blank(const glyph::core::Cell &c) noexcept {
+    constexpr std::uint16_t kVisibleOnBlank =
+        glyph::core::Style::AttrUnderline | glyph::core::Style::AttrStrike;
+    return c.width == 1 && (c.ch == U' ' || c.ch == 0) &&
+           (c.style.attrs & kVisibleOnBlank) == 0;
+  }
+
+  static bool same_bg(const glyph::core::Style &a,
+                      const glyph::core::Style &b) noexcept {
+    if (a.bg_is_default() || b.bg_is_default())
+      return a.bg_is_default() == b.bg_is_default();
+    return a.bg_rgb == b.bg_rgb;
+  }
+
+  static std::size_t decimal_digits(std::uint32_t v) noexcept {
+    std::size_t n = 1;
+    for (; v >= 10; v /= 10)
+      ++n;
+    return n;
+  }
+
+  static std::size_t utf8_size(char32_t cp) noexcept {
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+  }
+
+  // Length of the run of erasable blanks sharing `bg` in [x, x1) of row y.
+  static glyph::core::coord_t blank_run(glyph::core::ConstBufferView buf,
+                                        glyph::core::coord_t         y,
+                                        glyph::core::coord_t         x,
+                                        glyph::core::coord_t         x1,
+                                        const glyph::core::Style    &bg) {
+    glyph::core::coord_t end = x;
+    while (end < x1) {
+      const auto &c = buf.at(end, y);
+      if (!erasable_blank(c) || !same_bg(c.style, bg))
+        break;
+      ++end;
+    }
+    return glyph::core::coord_t(end - x);
+  }
+
+  // Clear the blank run starting at (x, y) with EL or ECH when that is
+  // cheaper than printing it. On success `run` is the number of span cells
+  // covered and the cursor is left wherever the erase put it.
+  bool AnsiRenderer::try_erase_(glyph::core::ConstBufferView buf,
+                                glyph::core::coord_t         y,
+                                glyph::core::coord_t         x,
+                                glyph::core::coord_t         x1,
+                                glyph::core::coord_t        &run) {
+    const auto &cell = buf.at(x, y);
+    run              = blank_run(buf, y, x, x1, cell.style);
+    const auto end   = glyph::core::coord_t(x + run);
+
+    // Cells past the span are unchanged; if they are matching blanks too,
+    // erasing them is invisible, so EL can take the whole tail.
+    const bool to_eol =
+        end == x1 && blank_run(buf, y, x1, buf.size.w, cell.style) ==
+                         buf.size.w - x1;
+
+    std::size_t cost = 0;
+    if (to_eol) {
+      cost = 3; // ESC [ K
     }
     else {
-      const std::uint32_t rgb = s.fg_rgb;
-      const std::uint32_t r   = (rgb >> 16) & 0xFFu;
-      const std::uint32_t g   = (rgb >> 8) & 0xFFu;
-      const std::uint32_t b   = rgb & 0xFFu;
-      out << ";38;2;" << r << ";" << g << ";" << b;
+      cost = run == 1 ? 3 : 3 + decimal_digits(std::uint32_t(run));
+      if (end < x1) {
+        cost += cursor_move_cost(CursorState::known_at({x, y}), {end, y});
+      }
     }
+    if (cost >= std::size_t(run))
+      return false;
 
-    if (s.bg_is_default()) {
-      out << ";49";
+    if (!pen_known_ || !same_bg(pen_, cell.style)) {
+      apply_style_(cell.style);
+    }
+    if (to_eol) {
+      out_.append("\x1b[K");
     }
     else {
-      const std::uint32_t rgb = s.bg_rgb;
-      const std::uint32_t r   = (rgb >> 16) & 0xFFu;
-      const std::uint32_t g   = (rgb >> 8) & 0xFFu;
-      const std::uint32_t b   = rgb & 0xFFu;
-      out << ";48;2;" << r << ";" << g << ";" << b;
+      out_.append("\x1b[");
+      if (run != 1) {
+        out_.append_uint(std::uint32_t(run));
+      }
+      out_.append('X');
     }
 
-    out << "m";
+    // EL/ECH leave the cursor in place.
+    cursor_ = CursorState::known_at({x, y});
+    if (end < x1) {
+      encode_cursor_move(out_, cursor_, {end, y});
+      ++stats_.cursor_moves;
+      cursor_ = CursorState::known_at({end, y});
+    }
+    return true;
   }
 
-  // Encode a single codepoint as UTF-8 into the output stream.
-  static void emit_utf8(std::ostream &out, char32_t cp) noexcept {
-    if (cp == 0) {
-      out << ' ';
-      return;
+  // Print cells [x0, x1) of row y at the cursor, tracking pen and cursor.
+  void AnsiRenderer::emit_cells_(glyph::core::ConstBufferView buf,
+                                 glyph::core::coord_t         y,
+                                 glyph::core::coord_t         x0,
+                                 glyph::core::coord_t         x1) {
+    stats_.cells += std::uint64_t(x1 - x0);
+    glyph::core::coord_t x = x0;
+    while (x < x1) {
+      const auto &cell = buf.at(x, y);
+
+      if (cell.width == 0) {
+        out_.append(' ');
+        ++x;
+        continue;
+      }
+
+      if (options_.erase_blanks && erasable_blank(cell)) {
+        glyph::core::coord_t run = 0;
+        if (try_erase_(buf, y, x, x1, run)) {
+          x = glyph::core::coord_t(x + run);
+          if (x >= x1)
+            return; // cursor_ already set by the erase
+          continue;
+        }
+      }
+
+      apply_style_(cell.style);
+      emit_utf8(out_, buf, cell.ch);
+
+      if (options_.repeat_glyphs && cell.width == 1 && cell.ch >= 0x20 &&
+          cell.ch != 0x7F && !glyph::core::is_cluster(cell.ch)) {
+        // REP repeats the glyph just printed.
+        glyph::core::coord_t end = glyph::core::coord_t(x + 1);
+        while (end < x1) {
+          const auto &c = buf.at(end, y);
+          if (c.ch != cell.ch || c.width != 1 || !same_pen(c.style, pen_))
+            break;
+          ++end;
+        }
+        const auto n = std::uint32_t(end - x - 1);
+        if (n != 0 && (n == 1 ? 3 : 3 + decimal_digits(n)) <
+                          n * utf8_size(cell.ch)) {
+          out_.append("\x1b[");
+          if (n != 1) {
+            out_.append_uint(n);
+          }
+          out_.append('b');
+          x = end;
+          continue;
+        }
+      }
+
+      // The terminal advances two columns for a wide glyph on its own.
+      // Skip the paired spacer cell without emitting anything, or the
+      // terminal cursor would drift one column ahead of the model.
+      x += (cell.width == 2) ? 2 : 1;
     }
-    if (cp < 0x80) {
-      out << static_cast<char>(cp);
-    } else if (cp < 0x800) {
-      out << static_cast<char>(0xC0 | (cp >> 6));
-      out << static_cast<char>(0x80 | (cp & 0x3F));
-    } else if (cp < 0x10000) {
-      out << static_cast<char>(0xE0 | (cp >> 12));
-      out << static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-      out << static_cast<char>(0x80 | (cp & 0x3F));
-    } else if (cp < 0x110000) {
-      out << static_cast<char>(0xF0 | (cp >> 18));
-      out << static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
-      out << static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-      out << static_cast<char>(0x80 | (cp & 0x3F));
-    } else {
-      out << '?';
+
+    // With autowrap off, printing into the last column parks the cursor
+    // there; treat the column as unknown rather than guess.
+    cursor_.pos       = glyph::core::Point{x, y};
+    cursor_.row_known = true;
+    cursor_.col_known = x < buf.size.w;
+  }
+
+  // Bytes needed to re-print the unchanged cells [x0, x1) of row y with the
+  // current pen, or `limit` if re-printing is not possible / not cheaper.
+  std::size_t AnsiRenderer::reprint_cost_(glyph::core::ConstBufferView buf,
+                                          glyph::core::coord_t         y,
+                                          glyph::core::coord_t         x0,
+                                          glyph::core::coord_t         x1,
+                                          std::size_t limit) const {
+    if (!pen_known_)
+      return limit;
+
+    std::size_t          cost = 0;
+    glyph::core::coord_t x    = x0;
+    while (x < x1) {
+      const auto &cell = buf.at(x, y);
+      // Landing inside a wide glyph, running past the target, needing a
+      // style switch, or a grapheme cluster (whose rendered width the
+      // terminal may disagree on) all make the move option the better one.
+      if (cell.width == 0 || x + cell.width > x1 ||
+          !same_pen(cell.style, pen_) || glyph::core::is_cluster(cell.ch))
+        return limit;
+
+      cost += utf8_size(cell.ch);
+      if (cost >= limit)
+        return limit;
+      x += cell.width;
     }
+    return cost;
+  }
+
+  // Move the cursor to (x, y): either re-print the unchanged gap from the
+  // current position or take the cheapest escape sequence.
+  void AnsiRenderer::move_to_(glyph::core::ConstBufferView buf,
+                              glyph::core::coord_t         y,
+                              glyph::core::coord_t         x) {
+    const glyph::core::Point to{x, y};
+    if (cursor_.at(to))
+      return;
+
+    const std::size_t move_cost = cursor_move_cost(cursor_, to);
+    if (cursor_.known() && cursor_.pos.y == y && cursor_.pos.x < x &&
+        reprint_cost_(buf, y, cursor_.pos.x, x, move_cost) < move_cost) {
+      emit_cells_(buf, y, cursor_.pos.x, x);
+      return;
+    }
+
+    encode_cursor_move(out_, cursor_, to);
+    ++stats_.cursor_moves;
+    cursor_ = CursorState::known_at(to);
   }
 
   // Render a single dirty span with style tracking.
-  static void render_span(
-      std::ostream                &out,
-      glyph::core::ConstBufferView buf,
-      glyph::core::DiffSpan        span,
-      glyph::core::Style          &current,
-      bool                        &has_current) {
+  void AnsiRenderer::render_span_(glyph::core::ConstBufferView buf,
+                                  glyph::core::DiffSpan        span) {
     if (span.empty())
       return;
 
-    ansi_move(out, span.y, span.x0);
+    move_to_(buf, span.y, span.x0);
+    emit_cells_(buf, span.y, span.x0, span.x1);
+  }
 
-    for (glyph::core::coord_t x = span.x0; x < span.x1; ++x) {
-      const auto &cell = buf.at(x, span.y);
+  // Look for a vertically shifted row block between prev_ and cur. On a hit,
+  // scroll it on the terminal, apply the same shift to prev_ (and its
+  // hashes), and rebuild changed_lines_ against the scrolled shadow so only
+  // the exposed (and otherwise changed) rows are repainted. Neither side is
+  // rehashed: cur's clean rows answer from their cache.
+  bool AnsiRenderer::try_scroll_(const glyph::core::Buffer &cur) {
+    const auto size = cur.size();
+    next_hashes_.resize(std::size_t(size.h));
+    for (glyph::core::coord_t y = 0; y < size.h; ++y) {
+      next_hashes_[std::size_t(y)] = cur.row_hash(y);
+    }
 
-      if (cell.width == 0) {
-        out << ' ';
-        continue;
-      }
+    const auto view = cur.const_view();
+    const auto hint = glyph::core::detect_scroll_by_hash(
+        committed_hashes_, next_hashes_, kScrollMinRows,
+        [&](glyph::core::coord_t py, glyph::core::coord_t ny) {
+          return glyph::core::rows_equal(prev_.const_view(), py, view, ny);
+        });
+    if (hint.empty())
+      return false;
+
+    // Lines exposed by SU/SD are erased with the pen's background; keep it
+    // at defaults so they match a blank Cell{}.
+    reset_pen_();
+
+    const auto n = hint.shift > 0 ? hint.shift : -hint.shift;
+    out_.append("\x1b[");
+    out_.append_uint(std::uint32_t(hint.top + 1));
+    out_.append(';');
+    out_.append_uint(std::uint32_t(hint.bottom));
+    out_.append("r\x1b[");
+    if (n != 1) {
+      out_.append_uint(std::uint32_t(n));
+    }
+    out_.append(hint.shift > 0 ? 'S' : 'T');
+    // Restore full-screen margins; DECSTBM homes the cursor.
+    out_.append("\x1b[r");
+    cursor_ = CursorState::known_at(glyph::core::Point{0, 0});
+
+    prev_.shift_rows(hint.top, hint.bottom, hint.shift);
+
+    const auto first = committed_hashes_.begin() + hint.top;
+    const auto last  = committed_hashes_.begin() + hint.bottom;
+    const auto blank = blank_row_hash_(size.w);
+    if (hint.shift > 0) {
+      std::fill(std::move(first + n, last, first), last, blank);
+    }
+    else {
+      std::fill(first, std::move_backward(first, last - n, last), blank);
+    }
 
-      if (!has_current || cell.style != current) {
-        ansi_apply_style(out, cell.style);
-        current     = cell.style;
-        has_current = true;
+    changed_lines_.clear();
+    for (glyph::core::coord_t y = 0; y < size.h; ++y) {
+      if (committed_hashes_[std::size_t(y)] != next_hashes_[std::size_t(y)]) {
+        changed_lines_.push_back(glyph::core::DirtyRow{y, 0, size.w});
       }
+    }
+    return true;
+  }
 
-      emit_utf8(out, cell.ch);
-
-      if (cell.width == 2) {
-        // The terminal advances two columns for a wide glyph on its own.
-        // Skip the paired spacer cell without emitting anything, or the
-        // terminal cursor would drift one column ahead of the model.
-        ++x;
+  // Hand the encoded frame to the sink and recycle the arena.
+  void AnsiRenderer::commit_() {
+    const auto start = StatsClock::now();
+    if (!out_.empty()) {
+      if (options_.synchronized_output) {
+        const std::string_view parts[] = {
+            "\x1b[?2026h", out_.view(), "\x1b[?2026l"};
+        sink_.write_parts(parts);
+        stats_.bytes += parts[0].size() + out_.size() + parts[2].size();
+      }
+      else {
+        sink_.write(out_.view());
+        stats_.bytes += out_.size();
       }
     }
+    sink_.flush();
+    out_.clear();
+    stats_.write_ns += elapsed_ns(start);
+  }
+
+  // Close the stats of the call that started at `start`: whatever time the
+  // timed stages do not account for was spent encoding.
+  void AnsiRenderer::finish_stats_(StatsClock::time_point start) noexcept {
+    const std::uint64_t total = elapsed_ns(start);
+    const std::uint64_t timed =
+        stats_.dirty_ns + stats_.hash_ns + stats_.diff_ns + stats_.write_ns;
+    stats_.encode_ns = total > timed ? total - timed : 0;
+    stats_window_.push(stats_);
   }
 
   void AnsiRenderer::render(const view::Frame &frame) {
+    const auto start = StatsClock::now();
+    stats_           = RenderStats{};
+    render_(frame);
+    finish_stats_(start);
+  }
+
+  void AnsiRenderer::render_(const view::Frame &frame) {
+    out_.clear();
+    // Whatever reached the terminal since the last frame (a resize, a user
+    // print, a reply) may have moved the cursor: plan from an absolute move.
+    cursor_ = CursorState::unknown();
+
     if (frame.empty()) {
       if (has_prev_) {
-        out_ << "\x1b[2J\x1b[H\x1b[0m";
-        out_.flush();
+        out_.append("\x1b[2J\x1b[H\x1b[0m");
+        commit_();
+        cursor_   = CursorState::known_at(glyph::core::Point{0, 0});
         has_prev_ = false;
+        set_default_pen_();
       }
       return;
     }
 
-    const auto size = frame.size();
-    const auto cur  = frame.view();
+    // Backpressure: the terminal has not taken the previous frame yet.
+    // Queueing this one would only replay stale state; keep it in target_
+    // instead, to be diffed in full against the shadow (which is what the
+    // terminal shows once the queue drains) by render_pending() or the
+    // next render().
+    if (options_.skip_congested_frames && sink_.bytes_outstanding() != 0) {
+      sink_.flush();
+      if (sink_.bytes_outstanding() != 0) {
+        keep_skipped_(frame);
+        return;
+      }
+    }
 
-    std::ostringstream buf;
+    const auto  size = frame.size();
+    const auto &buf  = frame.buffer();
+
+    // Recycle a table filling up with styles no longer in use, before it
+    // runs out and SGR falls back to pen-keyed cache entries.
+    if (styles_.size() > glyph::core::StyleTable::kFull / 2) {
+      clear_styles_();
+    }
+
+    // A cluster tag that changed meaning since the shadow was drawn would
+    // diff as unchanged: redraw instead.
+    if (has_prev_ && prev_.size() == size && !adopt_clusters_(buf)) {
+      has_prev_ = false;
+    }
 
     // First frame or size change: full redraw.
     if (!has_prev_ || prev_.size() != size) {
-      buf << "\x1b[H\x1b[0m";
-      ansi_wrap(buf, false);
-
-      glyph::core::Style current{};
-      bool               has_current = false;
+      if (has_prev_ && hold_resize_(frame))
+        return;
+      stats_.full_redraw = true;
+      stats_.dirty_lines = std::uint32_t(size.h);
+      (void)frame.take_dirty_into(dirty_rows_);
+      full_redraw_(buf, frame.cursor());
+      return;
+    }
+    if (resize_held_) {
+      // Back to the size on screen before the hold ran out. The held
+      // frames took their dirty lines with them, as skipped frames do.
+      resize_held_ = false;
+      stale_       = true;
+    }
 
+    // Dirty rows only, each narrowed to the columns the frame wrote.
+    auto stage = StatsClock::now();
+    (void)frame.take_dirty_into(dirty_rows_);
+    if (stale_) {
+      // Skipped frames took their dirty lines with them: every row is a
+      // candidate against the shadow.
+      dirty_rows_.clear();
       for (glyph::core::coord_t y = 0; y < size.h; ++y) {
-        for (glyph::core::coord_t x = 0; x < size.w; ++x) {
-          const auto &cell = cur.at(x, y);
-
-          if (cell.width == 0) {
-            buf << ' ';
-            continue;
-          }
-
-          if (!has_current || cell.style != current) {
-            ansi_apply_style(buf, cell.style);
-            current     = cell.style;
-            has_current = true;
-          }
-
-          emit_utf8(buf, cell.ch);
-
-          if (cell.width == 2) {
-            // Wide glyph already occupies two terminal columns; just skip
-            // its spacer cell so the cursor stays aligned with the model.
-            ++x;
-          }
+        dirty_rows_.push_back(glyph::core::DirtyRow{y, 0, size.w});
+      }
+      stale_ = false;
+    }
+    else if (pending_) {
+      // Rows a budgeted frame did not finish are still behind, in full.
+      merged_rows_.clear();
+      std::size_t i = 0;
+      for (glyph::core::coord_t y = 0; y < size.h; ++y) {
+        const bool written = i < dirty_rows_.size() && dirty_rows_[i].y == y;
+        if (carried_[std::size_t(y)]) {
+          merged_rows_.push_back(glyph::core::DirtyRow{y, 0, size.w});
         }
-        if (y + 1 < size.h) {
-          buf << "\r\n";
+        else if (written) {
+          merged_rows_.push_back(dirty_rows_[i]);
         }
+        i += written ? 1 : 0;
       }
-
-      ansi_wrap(buf, true);
-      ansi_reset(buf);
-
-      prev_.resize(size);
-      prev_.blit(cur, glyph::core::Point{0, 0});
-      has_prev_ = true;
-
-      ansi_apply_cursor(buf, frame.cursor());
-      prev_cursor_     = frame.cursor();
-      has_prev_cursor_ = true;
-      out_ << buf.str();
-      out_.flush();
-      return;
+      dirty_rows_.swap(merged_rows_);
     }
-
-    // Dirty lines only.
-    const auto dirty_lines = frame.take_dirty_lines();
-    if (dirty_lines.empty()) {
+    stats_.dirty_lines = std::uint32_t(dirty_rows_.size());
+    stats_.dirty_ns    = elapsed_ns(stage);
+    if (dirty_rows_.empty()) {
       reconcile_cursor(frame.cursor());
       return;
     }
 
-    const auto                        prev_view = prev_.const_view();
-    std::vector<glyph::core::coord_t> changed_lines;
-    if (dirty_lines.size() < std::size_t(size.h / 4)) {
-      changed_lines.reserve(dirty_lines.size());
-      for (auto y : dirty_lines) {
-        if (glyph::core::hash_line(prev_view, y) !=
-            glyph::core::hash_line(cur, y)) {
-          changed_lines.push_back(y);
-        }
+    stage = StatsClock::now();
+    // Drop rows that were written but did not change: the frame hashes each
+    // written row once, the shadow's hash was kept when the row was stored.
+    // (A 64-bit collision would leave one row stale until it next changes.)
+    changed_lines_.clear();
+    for (const auto &row : dirty_rows_) {
+      if (committed_hashes_[std::size_t(row.y)] != buf.row_hash(row.y)) {
+        changed_lines_.push_back(row);
       }
+    }
+    if (changed_lines_.empty()) {
+      stats_.hash_ns = elapsed_ns(stage);
+      pending_       = false;
+      reconcile_cursor(frame.cursor());
+      return;
+    }
 
-      if (changed_lines.empty()) {
-        reconcile_cursor(frame.cursor());
-        return;
-      }
+    if (options_.scroll_regions &&
+        changed_lines_.size() >= std::size_t(kScrollMinRows)) {
+      try_scroll_(buf);
     }
-    else {
-      changed_lines.assign(dirty_lines.begin(), dirty_lines.end());
+    stats_.hash_ns = elapsed_ns(stage);
+
+    emit_changes_(buf, frame.cursor());
+  }
+
+  // First frame / resize: clear the screen and send the frame as a diff
+  // against a blank shadow. Default blanks then cost nothing; everything
+  // else goes out as spans with planned cursor jumps, and blank runs on a
+  // coloured background as ECH/EL. Under a byte budget the redraw may span
+  // several ticks, and rows not sent yet show blanks instead of the old
+  // layout.
+  void AnsiRenderer::full_redraw_(const glyph::core::Buffer     &cur,
+                                  const view::Frame::CursorHint &hint) {
+    const auto size = cur.size();
+
+    out_.append("\x1b[0m\x1b[2J\x1b[H");
+    set_default_pen_();
+    cursor_ = CursorState::known_at(glyph::core::Point{0, 0});
+
+    prev_.resize(size);
+    prev_.clear();
+    (void)prev_.clusters().adopt_all(cur.clusters()); // empty: cannot clash
+    committed_hashes_.assign(std::size_t(size.h), blank_row_hash_(size.w));
+    has_prev_    = true;
+    stale_       = false;
+    pending_     = false;
+    resize_held_ = false;
+
+    changed_lines_.clear();
+    for (glyph::core::coord_t y = 0; y < size.h; ++y) {
+      changed_lines_.push_back(glyph::core::DirtyRow{y, 0, size.w});
     }
+    emit_changes_(cur, hint);
+  }
 
-    ansi_wrap(buf, false);
+  // With resize_debounce set, keep a frame of a new size in target_ instead
+  // of redrawing, until the size has held still long enough. Returns true
+  // if the frame was held.
+  bool AnsiRenderer::hold_resize_(const view::Frame &frame) {
+    if (options_.resize_debounce.count() <= 0)
+      return false;
+    const auto now = StatsClock::now();
+    if (!resize_held_ || target_.size() != frame.size()) {
+      resize_since_ = now;
+    }
+    if (now - resize_since_ >= options_.resize_debounce)
+      return false;
 
-    glyph::core::Style current{};
-    bool               has_current = false;
+    (void)frame.take_dirty_into(dirty_rows_);
+    if (target_.size() != frame.size()) {
+      target_.resize(frame.size());
+    }
+    target_.clusters().clear();
+    target_.blit(frame.view(), glyph::core::Point{0, 0});
+    held_cursor_   = frame.cursor();
+    resize_held_   = true;
+    pending_       = false; // rows carried for the old size are moot
+    stats_.skipped = true;
+    return true;
+  }
 
-    const auto spans = glyph::core::diff_spans(prev_view, cur, changed_lines);
+  // Keep a frame the congested sink could not take as the pending target.
+  // Its dirty lines are dropped with it, so every row is a candidate.
+  void AnsiRenderer::keep_skipped_(const view::Frame &frame) {
+    frame.clear_dirty_lines();
+    target_      = frame.buffer();
+    held_cursor_ = frame.cursor();
+    carried_.assign(std::size_t(frame.size().h), std::uint8_t(1));
+    stale_         = true;
+    pending_       = true;
+    stats_.skipped = true;
+    ++frames_skipped_;
+  }
 
-    for (const auto &span : spans) {
-      render_span(buf, cur, span, current, has_current);
+  // Encode the spans between prev_ and cur on changed_lines_, honouring the
+  // byte budget, then copy what was actually sent into prev_.
+  void AnsiRenderer::emit_changes_(const glyph::core::Buffer     &buf,
+                                   const view::Frame::CursorHint &hint) {
+    const auto cur = buf.const_view();
+    ansi_wrap(out_, false);
+
+    stats_.changed_lines = std::uint32_t(changed_lines_.size());
+    const auto stage     = StatsClock::now();
+    spans_.clear();
+    glyph::core::diff_spans(prev_.const_view(), cur, changed_lines_, spans_);
+    stats_.diff_ns = elapsed_ns(stage);
+
+    const std::size_t sent = options_.byte_budget != 0
+                                 ? emit_budgeted_(cur)
+                                 : spans_.size();
+    stats_.spans = std::uint32_t(sent);
+    if (options_.byte_budget == 0) {
+      for (const auto &span : spans_) {
+        render_span_(cur, span);
+      }
     }
 
-    ansi_wrap(buf, true);
-    ansi_reset(buf);
+    ansi_wrap(out_, true);
+    reset_pen_();
 
-    prev_.blit(cur, glyph::core::Point{0, 0});
+    // prev_ learns exactly what the terminal was sent, so keeping it
+    // current costs as much as the change, not the frame.
+    for (std::size_t i = 0; i < sent; ++i) {
+      store_span_(buf, spans_[i]);
+    }
+    if (sent == spans_.size()) {
+      pending_ = false;
+    }
+    else {
+      carried_.assign(std::size_t(cur.size.h), std::uint8_t(0));
+      for (std::size_t i = sent; i < spans_.size(); ++i) {
+        carried_[std::size_t(spans_[i].y)] = 1;
+      }
+      if (&buf != &target_) {
+        target_ = buf; // verbatim, cluster tags included
+      }
+      held_cursor_ = hint;
+      pending_     = true;
+    }
 
-    ansi_apply_cursor(buf, frame.cursor());
-    prev_cursor_     = frame.cursor();
+    apply_cursor_(hint);
+    prev_cursor_     = hint;
     has_prev_cursor_ = true;
-    out_ << buf.str();
-    out_.flush();
+    commit_();
+  }
+
+  // Emit spans in priority order until the byte budget is spent. Rows go
+  // out whole (gap re-prints and EL may touch any cell of a row being
+  // painted, so a half-sent row could leave the shadow wrong). Returns how
+  // many of the reordered spans_ were sent; the first row always is.
+  std::size_t
+  AnsiRenderer::emit_budgeted_(glyph::core::ConstBufferView cur) {
+    // Focus region first, then rows changed by this frame, then rows left
+    // over from earlier frames.
+    row_rank_.assign(std::size_t(cur.size.h), std::uint8_t(0xFF));
+    for (const auto &sp : spans_) {
+      const bool in_focus = !priority_.empty() && sp.y >= priority_.top() &&
+                            sp.y < priority_.bottom() &&
+                            sp.x0 < priority_.right() &&
+                            sp.x1 > priority_.left();
+      std::uint8_t r = in_focus ? 0 : 2;
+      if (pending_ && carried_[std::size_t(sp.y)])
+        r = std::uint8_t(r + 1);
+      auto &slot = row_rank_[std::size_t(sp.y)];
+      slot       = std::min(slot, r);
+    }
+    std::stable_sort(spans_.begin(), spans_.end(),
+                     [&](const glyph::core::DiffSpan &a,
+                         const glyph::core::DiffSpan &b) {
+                       return row_rank_[std::size_t(a.y)] <
+                              row_rank_[std::size_t(b.y)];
+                     });
+
+    std::size_t sent = 0;
+    for (const auto &span : spans_) {
+      if (sent != 0 && span.y != spans_[sent - 1].y &&
+          out_.size() >= options_.byte_budget)
+        break;
+      render_span_(cur, span);
+      ++sent;
+    }
+    return sent;
+  }
+
+  bool AnsiRenderer::render_pending() {
+    if (resize_held_) {
+      if (StatsClock::now() - resize_since_ < options_.resize_debounce)
+        return true;
+      const auto start   = StatsClock::now();
+      stats_             = RenderStats{};
+      stats_.full_redraw = true;
+      stats_.dirty_lines = std::uint32_t(target_.size().h);
+      out_.clear();
+      full_redraw_(target_, held_cursor_);
+      finish_stats_(start);
+      return has_pending();
+    }
+    if (sink_.bytes_outstanding() != 0) {
+      sink_.flush();
+    }
+    if (!pending_)
+      return has_pending();
+    const auto start = StatsClock::now();
+    stats_           = RenderStats{};
+    out_.clear();
+    if (options_.skip_congested_frames && sink_.bytes_outstanding() != 0) {
+      stats_.skipped = true;
+      finish_stats_(start);
+      return true;
+    }
+
+    cursor_ = CursorState::unknown();
+    if (!has_prev_ || prev_.size() != target_.size() ||
+        !adopt_clusters_(target_)) {
+      // A kept skipped frame of a new size, with no shadow to diff, or
+      // with a cluster tag that changed meaning.
+      stats_.full_redraw = true;
+      stats_.dirty_lines = std::uint32_t(target_.size().h);
+      full_redraw_(target_, held_cursor_);
+      finish_stats_(start);
+      return has_pending();
+    }
+    // Every row a skipped frame left behind is in carried_ now.
+    stale_ = false;
+    changed_lines_.clear();
+    for (glyph::core::coord_t y = 0; y < target_.size().h; ++y) {
+      if (carried_[std::size_t(y)]) {
+        changed_lines_.push_back(
+            glyph::core::DirtyRow{y, 0, target_.size().w});
+      }
+    }
+    stats_.dirty_lines = std::uint32_t(changed_lines_.size());
+    emit_changes_(target_, held_cursor_);
+    finish_stats_(start);
+    return has_pending();
   }
 
-  // Emit a cursor update directly to the stream, but only when the hint
+  // Emit a cursor update directly to the sink, but only when the hint
   // differs from the last one applied — avoids redundant escape output on
   // frames where nothing (including the caret) moved.
   void AnsiRenderer::reconcile_cursor(const view::Frame::CursorHint &hint) {
@@ -298,10 +899,9 @@ namespace glyph::render {
         prev_cursor_.pos == hint.pos) {
       return;
     }
-    std::ostringstream buf;
-    ansi_apply_cursor(buf, hint);
-    out_ << buf.str();
-    out_.flush();
+    out_.clear();
+    apply_cursor_(hint);
+    commit_();
     prev_cursor_     = hint;
     has_prev_cursor_ = true;
   }
@@ -0,0 +1,229 @@
+// glyph/render/ansi/cursor_motion.cpp
+//
+// Cheapest-move selection between CUP and relative cursor sequences.
+//
+// A move is modelled as an optional vertical step followed by an optional
+// horizontal step (or a single absolute CUP). LF is only ever used right
+// after CR: with output post-processing on, LF may also return the carriage,
+// so CR+LF is the only form whose resulting column is certain either way.
+
+#include "glyph/render/ansi/cursor_motion.h"
+
+#include <cstdint>
+
+namespace glyph::render {
+
+  namespace {
+
+    using core::coord_t;
+
+    enum class VStep : std::uint8_t {
+      None,
+      Up,   // CUU n
+      Down, // CUD n
+      CrLf, // CR + LF * n (leaves the column at 0)
+    };
+
+    enum class HStep : std::uint8_t {
+      None,
+      Fwd,   // CUF n
+      Back,  // CUB n
+      Cr,    // CR
+      CrFwd, // CR + CUF n
+      Cha,   // CHA col
+    };
+
+    struct Plan final {
+      bool        cup = false;
+      VStep       v   = VStep::None;
+      HStep       h   = HStep::None;
+      coord_t     vn  = 0;
+      coord_t     hn  = 0;
+      std::size_t cost = 0;
+    };
+
+    constexpr std::size_t digits(std::uint32_t v) noexcept {
+      std::size_t n = 1;
+      while (v >= 10) {
+        v /= 10;
+        ++n;
+      }
+      return n;
+    }
+
+    // ESC [ n X, with n omitted when it is 1.
+    constexpr std::size_t csi_n_cost(coord_t n) noexcept {
+      return n == 1 ? 3 : 3 + digits(std::uint32_t(n));
+    }
+
+    constexpr std::size_t cup_cost(core::Point to) noexcept {
+      if (to.x == 0 && to.y == 0)
+        return 3; // ESC [ H
+      if (to.x == 0)
+        return 3 + digits(std::uint32_t(to.y + 1)); // ESC [ row H
+      return 4 + digits(std::uint32_t(to.y + 1)) +
+             digits(std::uint32_t(to.x + 1));
+    }
+
+    constexpr std::size_t cha_cost(coord_t col) noexcept {
+      return col == 0 ? 3 : 3 + digits(std::uint32_t(col + 1));
+    }
+
+    // Best horizontal step on the current row. `col_known` tells whether
+    // relative steps from `cx` are allowed.
+    void best_horizontal(
+        bool col_known, coord_t cx, coord_t tx, HStep &step, coord_t &n,
+        std::size_t &cost) {
+      if (col_known && cx == tx) {
+        step = HStep::None;
+        n    = 0;
+        cost = 0;
+        return;
+      }
+
+      step = HStep::Cha;
+      n    = tx;
+      cost = cha_cost(tx);
+
+      auto consider = [&](HStep s, coord_t nn, std::size_t c) {
+        if (c < cost) {
+          step = s;
+          n    = nn;
+          cost = c;
+        }
+      };
+
+      if (tx == 0) {
+        consider(HStep::Cr, 0, 1);
+      }
+      else {
+        consider(HStep::CrFwd, tx, 1 + csi_n_cost(tx));
+      }
+      if (col_known) {
+        if (tx > cx)
+          consider(HStep::Fwd, coord_t(tx - cx), csi_n_cost(tx - cx));
+        else
+          consider(HStep::Back, coord_t(cx - tx), csi_n_cost(cx - tx));
+      }
+    }
+
+    Plan plan_move(const CursorState &from, core::Point to) noexcept {
+      Plan best{};
+      best.cup  = true;
+      best.cost = cup_cost(to);
+
+      if (from.at(to)) {
+        best.cup  = false;
+        best.cost = 0;
+        return best;
+      }
+      if (!from.row_known) {
+        return best;
+      }
+
+      const coord_t dy = coord_t(to.y - from.pos.y);
+
+      // Vertical step that keeps the column, then a horizontal step.
+      {
+        Plan p{};
+        if (dy < 0) {
+          p.v  = VStep::Up;
+          p.vn = coord_t(-dy);
+          p.cost += csi_n_cost(p.vn);
+        }
+        else if (dy > 0) {
+          p.v  = VStep::Down;
+          p.vn = dy;
+          p.cost += csi_n_cost(p.vn);
+        }
+        std::size_t hc = 0;
+        best_horizontal(from.col_known, from.pos.x, to.x, p.h, p.hn, hc);
+        p.cost += hc;
+        if (p.cost < best.cost)
+          best = p;
+      }
+
+      // CR + LF * dy, then a horizontal step from column 0.
+      if (dy > 0) {
+        Plan p{};
+        p.v         = VStep::CrLf;
+        p.vn        = dy;
+        p.cost      = 1 + std::size_t(dy);
+        std::size_t hc = 0;
+        best_horizontal(true, 0, to.x, p.h, p.hn, hc);
+        p.cost += hc;
+        if (p.cost < best.cost)
+          best = p;
+      }
+
+      return best;
+    }
+
+    void emit_csi_n(OutputBuffer &out, coord_t n, char final_ch) {
+      out.append("\x1b[");
+      if (n != 1) {
+        out.append_uint(std::uint32_t(n));
+      }
+      out.append(final_ch);
+    }
+
+  } // namespace
+
+  std::size_t cursor_move_cost(const CursorState &from,
+                               core::Point        to) noexcept {
+    return plan_move(from, to).cost;
+  }
+
+  void encode_cursor_position(OutputBuffer &out, core::Point to) {
+    out.append("\x1b[");
+    if (to.x == 0 && to.y == 0) {
+      out.append('H');
+      return;
+    }
+    out.append_uint(std::uint32_t(to.y + 1));
+    if (to.x != 0) {
+      out.append(';');
+      out.append_uint(std::uint32_t(to.x + 1));
+    }
+    out.append('H');
+  }
+
+  void encode_cursor_move(OutputBuffer      &out,
+                          const CursorState &from,
+                          core::Point        to) {
+    const Plan p = plan_move(from, to);
+    if (p.cup) {
+      encode_cursor_position(out, to);
+      return;
+    }
+
+    switch (p.v) {
+    case VStep::None: break;
+    case VStep::Up:   emit_csi_n(out, p.vn, 'A'); break;
+    case VStep::Down: emit_csi_n(out, p.vn, 'B'); break;
+    case VStep::CrLf:
+      out.append('\r');
+      out.append(std::size_t(p.vn), '\n');
+      break;
+    }
+
+    switch (p.h) {
+    case HStep::None: break;
+    case HStep::Fwd:  emit_csi_n(out, p.hn, 'C'); break;
+    case HStep::Back: emit_csi_n(out, p.hn, 'D'); break;
+    case HStep::Cr:   out.append('\r'); break;
+    case HStep::CrFwd:
+      out.append('\r');
+      emit_csi_n(out, p.hn, 'C');
+      break;
+    case HStep::Cha:
+      out.append("\x1b[");
+      if (p.hn != 0) {
+        out.append_uint(std::uint32_t(p.hn + 1));
+      }
+      out.append('G');
+      break;
+    }
+  }
+
+} // namespace glyph::render
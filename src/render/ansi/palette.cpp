@@ -0,0 +1,184 @@
+// glyph/render/ansi/palette.cpp
+//
+// Palette quantization tables.
+//
+// The 256-color mapping is separable per channel: each channel snaps to the
+// nearest cube level through a 256-entry table, the gray ramp candidate comes
+// from a second table, and the closer of the two wins. The 16-color mapping
+// is not separable, so it uses a 32K-entry table over 5-bit channels, built
+// once on first use.
+
+#include "glyph/render/ansi/palette.h"
+
+#include <array>
+
+namespace glyph::render {
+
+  namespace {
+
+    constexpr std::uint8_t kCubeLevels[6] = {0, 95, 135, 175, 215, 255};
+
+    constexpr std::uint32_t red(std::uint32_t rgb) noexcept {
+      return (rgb >> 16) & 0xFFu;
+    }
+    constexpr std::uint32_t green(std::uint32_t rgb) noexcept {
+      return (rgb >> 8) & 0xFFu;
+    }
+    constexpr std::uint32_t blue(std::uint32_t rgb) noexcept {
+      return rgb & 0xFFu;
+    }
+
+    constexpr int dist2(std::uint32_t a, std::uint32_t b) noexcept {
+      const int dr = int(red(a)) - int(red(b));
+      const int dg = int(green(a)) - int(green(b));
+      const int db = int(blue(a)) - int(blue(b));
+      // Cheap perceptual weighting (green matters most, blue least).
+      return 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+    }
+
+    // Channel value -> nearest cube level index (0..5).
+    constexpr auto kCubeIndex = [] {
+      std::array<std::uint8_t, 256> t{};
+      for (int v = 0; v < 256; ++v) {
+        int best = 0;
+        for (int i = 1; i < 6; ++i) {
+          const int d  = v - kCubeLevels[i];
+          const int bd = v - kCubeLevels[best];
+          if (d * d < bd * bd)
+            best = i;
+        }
+        t[std::size_t(v)] = std::uint8_t(best);
+      }
+      return t;
+    }();
+
+    // Channel value -> exact cube level index, or 0xFF.
+    constexpr auto kCubeExact = [] {
+      std::array<std::uint8_t, 256> t{};
+      t.fill(0xFF);
+      for (int i = 0; i < 6; ++i)
+        t[kCubeLevels[i]] = std::uint8_t(i);
+      return t;
+    }();
+
+    // Gray level (average of channels) -> nearest ramp step (0..23).
+    // Ramp values are 8 + 10 * i.
+    constexpr auto kGrayIndex = [] {
+      std::array<std::uint8_t, 256> t{};
+      for (int v = 0; v < 256; ++v) {
+        int i = (v - 3) / 10;
+        if (v < 8)
+          i = 0;
+        if (i > 23)
+          i = 23;
+        t[std::size_t(v)] = std::uint8_t(i);
+      }
+      return t;
+    }();
+
+    // Channel value -> class among the base palette channel values
+    // {0x00, 0x80, 0xC0, 0xFF}, or 0xFF.
+    constexpr auto kBaseClass = [] {
+      std::array<std::uint8_t, 256> t{};
+      t.fill(0xFF);
+      t[0x00] = 0;
+      t[0x80] = 1;
+      t[0xC0] = 2;
+      t[0xFF] = 3;
+      return t;
+    }();
+
+    // (r, g, b) class triple -> base palette index, or -1.
+    constexpr auto kBaseByClass = [] {
+      std::array<std::int8_t, 64> t{};
+      t.fill(-1);
+      for (int i = 0; i < 16; ++i) {
+        const std::uint32_t c = kAnsiBasePalette[i];
+        const int key = kBaseClass[red(c)] * 16 + kBaseClass[green(c)] * 4 +
+                        kBaseClass[blue(c)];
+        t[std::size_t(key)] = std::int8_t(i);
+      }
+      return t;
+    }();
+
+    constexpr std::uint32_t cube_rgb(int r, int g, int b) noexcept {
+      return (std::uint32_t(kCubeLevels[r]) << 16) |
+             (std::uint32_t(kCubeLevels[g]) << 8) |
+             std::uint32_t(kCubeLevels[b]);
+    }
+
+    constexpr std::uint32_t gray_rgb(int i) noexcept {
+      const std::uint32_t v = std::uint32_t(8 + 10 * i);
+      return (v << 16) | (v << 8) | v;
+    }
+
+    // 15-bit (5 bits per channel) key -> nearest base color.
+    const std::array<std::uint8_t, 1u << 15> &palette16_table() {
+      static const auto table = [] {
+        std::array<std::uint8_t, 1u << 15> t{};
+        for (std::uint32_t key = 0; key < t.size(); ++key) {
+          // Sample at the center of each 8-wide channel bucket.
+          const std::uint32_t r   = ((key >> 10) & 0x1Fu) * 8 + 4;
+          const std::uint32_t g   = ((key >> 5) & 0x1Fu) * 8 + 4;
+          const std::uint32_t b   = (key & 0x1Fu) * 8 + 4;
+          const std::uint32_t rgb = (r << 16) | (g << 8) | b;
+
+          int best = 0;
+          for (int i = 1; i < 16; ++i) {
+            if (dist2(rgb, kAnsiBasePalette[i]) <
+                dist2(rgb, kAnsiBasePalette[best]))
+              best = i;
+          }
+          t[key] = std::uint8_t(best);
+        }
+        return t;
+      }();
+      return table;
+    }
+
+  } // namespace
+
+  std::uint8_t nearest_palette_256(std::uint32_t rgb) noexcept {
+    const int r = kCubeIndex[red(rgb)];
+    const int g = kCubeIndex[green(rgb)];
+    const int b = kCubeIndex[blue(rgb)];
+
+    const int gi =
+        kGrayIndex[(red(rgb) + green(rgb) + blue(rgb)) / 3u];
+
+    if (dist2(rgb, gray_rgb(gi)) < dist2(rgb, cube_rgb(r, g, b)))
+      return std::uint8_t(232 + gi);
+    return std::uint8_t(16 + 36 * r + 6 * g + b);
+  }
+
+  std::uint8_t nearest_palette_16(std::uint32_t rgb) noexcept {
+    const std::uint32_t key = ((red(rgb) >> 3) << 10) |
+                              ((green(rgb) >> 3) << 5) | (blue(rgb) >> 3);
+    return palette16_table()[key];
+  }
+
+  int exact_palette_index(std::uint32_t rgb) noexcept {
+    const std::uint8_t cr = kBaseClass[red(rgb)];
+    const std::uint8_t cg = kBaseClass[green(rgb)];
+    const std::uint8_t cb = kBaseClass[blue(rgb)];
+    if (cr != 0xFF && cg != 0xFF && cb != 0xFF) {
+      const int idx = kBaseByClass[std::size_t(cr * 16 + cg * 4 + cb)];
+      if (idx >= 0)
+        return idx;
+    }
+
+    const std::uint8_t r = kCubeExact[red(rgb)];
+    const std::uint8_t g = kCubeExact[green(rgb)];
+    const std::uint8_t b = kCubeExact[blue(rgb)];
+    if (r != 0xFF && g != 0xFF && b != 0xFF)
+      return 16 + 36 * r + 6 * g + b;
+
+    const std::uint32_t v = red(rgb);
+    if (v == green(rgb) && v == blue(rgb) && v >= 8 && v <= 238 &&
+        (v - 8) % 10 == 0)
+      return int(232 + (v - 8) / 10);
+
+    return -1;
+  }
+
+} // namespace glyph::render
@@ -0,0 +1,224 @@
+// glyph/render/ansi/sgr.cpp
+//
+// SGR encoding: full and delta (pen transition) forms, per color mode.
+
+#include "glyph/render/ansi/sgr.h"
+
+#include <string_view>
+
+namespace glyph::render {
+
+  namespace {
+
+    using core::Style;
+
+    // Fixed-capacity parameter list. The longest sequence we build is a
+    // reset, six attributes and two 24-bit colors (~50 bytes).
+    class SgrParams final {
+    public:
+      void push(std::uint32_t v) {
+        if (len_ != 0) {
+          buf_[len_++] = ';';
+        }
+        char  tmp[10];
+        char *end = tmp + sizeof(tmp);
+        char *p   = end;
+        do {
+          *--p = char('0' + v % 10u);
+          v /= 10u;
+        } while (v != 0);
+        while (p != end) {
+          buf_[len_++] = *p++;
+        }
+      }
+
+      void push_rgb(std::uint32_t lead, std::uint32_t rgb) {
+        push(lead);
+        push(2);
+        push((rgb >> 16) & 0xFFu);
+        push((rgb >> 8) & 0xFFu);
+        push(rgb & 0xFFu);
+      }
+
+      [[nodiscard]] bool empty() const noexcept {
+        return len_ == 0;
+      }
+
+      // Encoded size including the ESC [ ... m framing.
+      [[nodiscard]] std::size_t wire_size() const noexcept {
+        return len_ + 3;
+      }
+
+      void emit(OutputBuffer &out) const {
+        out.append("\x1b[");
+        out.append(std::string_view{buf_, len_});
+        out.append('m');
+      }
+
+    private:
+      char        buf_[64];
+      std::size_t len_ = 0;
+    };
+
+    struct AttrCode final {
+      std::uint16_t bit;
+      std::uint8_t  on;
+      std::uint8_t  off;
+    };
+
+    // Bold and dim share their "off" code (22).
+    constexpr AttrCode kAttrCodes[] = {
+        {Style::AttrBold, 1, 22},
+        {Style::AttrDim, 2, 22},
+        {Style::AttrItalic, 3, 23},
+        {Style::AttrUnderline, 4, 24},
+        {Style::AttrBlink, 5, 25},
+        {Style::AttrStrike, 9, 29},
+    };
+
+    // A color as it will be put on the wire for a given ColorMode.
+    struct ColorCode final {
+      enum Kind : std::uint8_t {
+        Default,
+        Base,    // 30-37 / 90-97 (fg), 40-47 / 100-107 (bg)
+        Indexed, // 38;5;n / 48;5;n
+        Rgb,     // 38;2;r;g;b / 48;2;r;g;b
+      };
+
+      Kind          kind  = Default;
+      std::uint32_t value = 0;
+
+      friend constexpr bool operator==(ColorCode a, ColorCode b) noexcept {
+        return a.kind == b.kind && a.value == b.value;
+      }
+    };
+
+    ColorCode resolve(bool is_default, std::uint32_t rgb, ColorMode mode) {
+      if (is_default || mode == ColorMode::Mono)
+        return {};
+
+      if (mode == ColorMode::Palette16)
+        return {ColorCode::Base, nearest_palette_16(rgb)};
+
+      const int exact = exact_palette_index(rgb);
+      if (exact >= 0 && exact < 16)
+        return {ColorCode::Base, std::uint32_t(exact)};
+
+      if (mode == ColorMode::Palette256)
+        return {ColorCode::Indexed, nearest_palette_256(rgb)};
+
+      if (exact >= 0)
+        return {ColorCode::Indexed, std::uint32_t(exact)};
+      return {ColorCode::Rgb, rgb};
+    }
+
+    ColorCode fg_code(const Style &s, ColorMode mode) {
+      return resolve(s.fg_is_default(), s.fg_rgb, mode);
+    }
+
+    ColorCode bg_code(const Style &s, ColorMode mode) {
+      return resolve(s.bg_is_default(), s.bg_rgb, mode);
+    }
+
+    void push_color(SgrParams &p, bool background, ColorCode c) {
+      switch (c.kind) {
+      case ColorCode::Default:
+        p.push(background ? 49 : 39);
+        break;
+      case ColorCode::Base:
+        if (c.value < 8)
+          p.push((background ? 40 : 30) + c.value);
+        else
+          p.push((background ? 100 : 90) + c.value - 8);
+        break;
+      case ColorCode::Indexed:
+        p.push(background ? 48 : 38);
+        p.push(5);
+        p.push(c.value);
+        break;
+      case ColorCode::Rgb:
+        p.push_rgb(background ? 48 : 38, c.value);
+        break;
+      }
+    }
+
+    void push_attrs_on(SgrParams &p, std::uint16_t attrs) {
+      for (const auto &a : kAttrCodes) {
+        if (attrs & a.bit) {
+          p.push(a.on);
+        }
+      }
+    }
+
+    void build_full(SgrParams &p, const Style &s, ColorMode mode) {
+      p.push(0);
+      push_attrs_on(p, s.attrs);
+      const ColorCode fg = fg_code(s, mode);
+      if (fg.kind != ColorCode::Default) {
+        push_color(p, false, fg);
+      }
+      const ColorCode bg = bg_code(s, mode);
+      if (bg.kind != ColorCode::Default) {
+        push_color(p, true, bg);
+      }
+    }
+
+    void build_delta(
+        SgrParams &p, const Style &from, const Style &to, ColorMode mode) {
+      std::uint16_t removed = std::uint16_t(from.attrs & ~to.attrs);
+      std::uint16_t added   = std::uint16_t(to.attrs & ~from.attrs);
+
+      constexpr std::uint16_t kIntensity = Style::AttrBold | Style::AttrDim;
+      if (removed & kIntensity) {
+        // 22 clears both bold and dim; re-enable whichever must survive.
+        p.push(22);
+        added = std::uint16_t(added | (to.attrs & kIntensity));
+        removed = std::uint16_t(removed & ~kIntensity);
+      }
+      for (const auto &a : kAttrCodes) {
+        if (removed & a.bit) {
+          p.push(a.off);
+        }
+      }
+      push_attrs_on(p, added);
+
+      const ColorCode fg = fg_code(to, mode);
+      if (!(fg == fg_code(from, mode))) {
+        push_color(p, false, fg);
+      }
+      const ColorCode bg = bg_code(to, mode);
+      if (!(bg == bg_code(from, mode))) {
+        push_color(p, true, bg);
+      }
+    }
+
+  } // namespace
+
+  void encode_sgr(OutputBuffer &out, const core::Style &s, ColorMode mode) {
+    SgrParams p;
+    build_full(p, s, mode);
+    p.emit(out);
+  }
+
+  void encode_sgr_transition(OutputBuffer      &out,
+                             const core::Style &from,
+                             const core::Style &to,
+                             ColorMode          mode) {
+    SgrParams delta;
+    build_delta(delta, from, to, mode);
+    if (delta.empty())
+      return;
+
+    SgrParams full;
+    build_full(full, to, mode);
+
+    // Prefer the delta on ties: it keeps unrelated pen state untouched.
+    if (delta.wire_size() <= full.wire_size()) {
+      delta.emit(out);
+    }
+    else {
+      full.emit(out);
+    }
+  }
+
+} // namespace glyph::render
@@ -0,0 +1,132 @@
+// glyph/render/ansi/sgr_cache.cpp
+//
+// Open-addressed SGR cache (linear probing, overwrite on a full run).
+
+#include "glyph/render/ansi/sgr_cache.h"
+
+#include <cstring>
+#include <string_view>
+
+#include "glyph/render/ansi/sgr.h"
+
+namespace glyph::render {
+
+  SgrCache::SgrCache(ColorMode mode)
+      : slots_(std::make_unique<Slot[]>(kSlots)), mode_(mode) {
+  }
+
+  void SgrCache::set_color_mode(ColorMode mode) noexcept {
+    if (mode_ == mode)
+      return;
+    mode_ = mode;
+    clear();
+  }
+
+  void SgrCache::clear() noexcept {
+    for (std::size_t i = 0; i < kSlots; ++i) {
+      slots_[i].key.kind = Kind::Empty;
+    }
+  }
+
+  SgrCache::Pen SgrCache::canonical_(const core::Style &s) noexcept {
+    Pen p{};
+    p.attrs = s.attrs;
+    p.flags = std::uint16_t(
+        s.flags & (core::Style::FlagFgDefault | core::Style::FlagBgDefault));
+    p.fg    = s.fg_is_default() ? 0 : s.fg_rgb;
+    p.bg    = s.bg_is_default() ? 0 : s.bg_rgb;
+    return p;
+  }
+
+  std::size_t SgrCache::hash_(const Key &k) noexcept {
+    auto mix = [](std::uint64_t h, std::uint64_t v) {
+      h ^= v;
+      h *= 0x9E3779B97F4A7C15ull;
+      return h ^ (h >> 29);
+    };
+    std::uint64_t h = 0x5851F42D4C957F2Dull * std::uint64_t(k.kind);
+    if (k.kind == Kind::IdFull || k.kind == Kind::IdTransition)
+      return std::size_t(mix(h, (std::uint64_t(k.from.fg) << 16) | k.to.fg));
+
+    h = mix(h, (std::uint64_t(k.to.fg) << 32) | k.to.bg);
+    h = mix(h, (std::uint64_t(k.to.attrs) << 16) | k.to.flags);
+    if (k.kind == Kind::Transition) {
+      h = mix(h, (std::uint64_t(k.from.fg) << 32) | k.from.bg);
+      h = mix(h, (std::uint64_t(k.from.attrs) << 16) | k.from.flags);
+    }
+    return std::size_t(h);
+  }
+
+  void SgrCache::lookup_(OutputBuffer      &out,
+                         const Key         &key,
+                         const core::Style *from,
+                         const core::Style &to) {
+    const std::size_t home = hash_(key) & (kSlots - 1);
+
+    Slot *victim = nullptr;
+    for (std::size_t i = 0; i < kMaxProbe; ++i) {
+      Slot &s = slots_[(home + i) & (kSlots - 1)];
+      if (s.key.kind == Kind::Empty) {
+        victim = &s;
+        break;
+      }
+      if (s.key == key) {
+        ++stats_.hits;
+        out.append(std::string_view{s.bytes, s.len});
+        return;
+      }
+    }
+    ++stats_.misses;
+    if (!victim) {
+      victim = &slots_[home];
+    }
+
+    // Encode straight into the output, then copy the new tail into the slot.
+    const std::size_t start = out.size();
+    if (from) {
+      encode_sgr_transition(out, *from, to, mode_);
+    }
+    else {
+      encode_sgr(out, to, mode_);
+    }
+    const std::string_view bytes = out.view().substr(start);
+    if (bytes.size() > kMaxBytes)
+      return;
+
+    victim->key = key;
+    victim->len = std::uint8_t(bytes.size());
+    std::memcpy(victim->bytes, bytes.data(), bytes.size());
+  }
+
+  void SgrCache::encode_transition(OutputBuffer      &out,
+                                   const core::Style &from,
+                                   const core::Style &to) {
+    lookup_(out, Key{canonical_(from), canonical_(to), Kind::Transition},
+            &from, to);
+  }
+
+  void SgrCache::encode_full(OutputBuffer &out, const core::Style &s) {
+    lookup_(out, Key{Pen{}, canonical_(s), Kind::Full}, nullptr, s);
+  }
+
+  void SgrCache::encode_transition(OutputBuffer           &out,
+                                   core::style_id_t        from,
+                                   core::style_id_t        to,
+                                   const core::StyleTable &table) {
+    Key key{};
+    key.from.fg = from;
+    key.to.fg   = to;
+    key.kind    = Kind::IdTransition;
+    lookup_(out, key, &table.style(from), table.style(to));
+  }
+
+  void SgrCache::encode_full(OutputBuffer           &out,
+                             core::style_id_t        s,
+                             const core::StyleTable &table) {
+    Key key{};
+    key.to.fg = s;
+    key.kind  = Kind::IdFull;
+    lookup_(out, key, nullptr, table.style(s));
+  }
+
+} // namespace glyph::render
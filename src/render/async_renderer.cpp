@@ -0,0 +1,98 @@
+// glyph/render/async_renderer.cpp
+//
+// Render thread and triple-buffer handoff.
+
+#include "glyph/render/async_renderer.h"
+
+#include <utility>
+
+namespace glyph::render {
+
+  AsyncRenderer::AsyncRenderer(Renderer &inner)
+      : inner_(inner), thread_([this] { run_(); }) {
+  }
+
+  AsyncRenderer::~AsyncRenderer() {
+    {
+      std::lock_guard lock(mu_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+
+  void AsyncRenderer::render(const view::Frame &frame) {
+    // back_ is private to this thread: the copy happens outside the lock and
+    // reuses the slot's storage when the size is unchanged.
+    *back_ = frame;
+    frame.clear_dirty_lines();
+
+    {
+      std::lock_guard lock(mu_);
+      if (fresh_) {
+        // The writer never saw ready_; carry its changes forward.
+        back_->merge_dirty_lines(*ready_);
+        ++stats_.collapsed;
+      }
+      std::swap(back_, ready_);
+      fresh_ = true;
+      ++stats_.published;
+    }
+    wake_.notify_one();
+  }
+
+  void AsyncRenderer::post(std::function<void()> task) {
+    {
+      std::lock_guard lock(mu_);
+      tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+  }
+
+  void AsyncRenderer::flush() {
+    std::unique_lock lock(mu_);
+    idle_.wait(lock, [this] { return !fresh_ && tasks_.empty() && !busy_; });
+  }
+
+  AsyncRenderer::Stats AsyncRenderer::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+  }
+
+  void AsyncRenderer::run_() {
+    std::vector<std::function<void()>> tasks;
+    std::unique_lock                   lock(mu_);
+    for (;;) {
+      wake_.wait(lock, [this] { return fresh_ || !tasks_.empty() || stop_; });
+      if (!fresh_ && tasks_.empty())
+        return; // stopping with nothing left to draw
+
+      tasks.swap(tasks_);
+      const bool draw = fresh_;
+      if (draw) {
+        std::swap(front_, ready_);
+        fresh_ = false;
+      }
+      busy_ = true;
+      lock.unlock();
+
+      for (auto &task : tasks) {
+        task();
+      }
+      tasks.clear();
+      if (draw) {
+        inner_.render(*front_);
+      }
+
+      lock.lock();
+      busy_ = false;
+      if (draw) {
+        ++stats_.rendered;
+      }
+      if (!fresh_ && tasks_.empty()) {
+        idle_.notify_all();
+      }
+    }
+  }
+
+} // namespace glyph::render
@@ -17,6 +17,8 @@ namespace glyph::render {
     //  - This assumes core::Cell has a printable glyph/char-like member.
     //  - If your Cell uses a different representation (rune, string, etc.),
     //    adjust this mapping here only; the pipeline stays the same.
+    if (glyph::core::is_cluster(c.ch))
+      return '?'; // grapheme cluster; not representable in one char
     return c.ch ? static_cast<char>(c.ch) : ' ';
   }
 
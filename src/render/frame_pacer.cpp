@@ -0,0 +1,104 @@
+// glyph/render/frame_pacer.cpp
+//
+// Frame pacer implementation.
+
+#include "glyph/render/frame_pacer.h"
+
+#include <algorithm>
+
+namespace glyph::render {
+
+  FramePacer::FramePacer(FramePacerOptions options) : options_(options) {
+    if (options_.max_fps > 0.0) {
+      interval_ = std::chrono::duration_cast<duration>(
+          std::chrono::duration<double>(1.0 / options_.max_fps));
+    }
+  }
+
+  // Called with mu_ held.
+  void FramePacer::schedule_(time_point due) {
+    if (has_frame_) {
+      due = std::max(due, last_frame_ + interval_);
+    }
+    ++requests_;
+    if (pending_) {
+      // Coalesce: the earlier deadline wins.
+      due_ = std::min(due_, due);
+      return;
+    }
+    pending_ = true;
+    due_     = due;
+  }
+
+  void FramePacer::invalidate(time_point now) {
+    {
+      std::lock_guard lock(mu_);
+      schedule_(now);
+    }
+    cv_.notify_all();
+  }
+
+  void FramePacer::request_frame(time_point now) {
+    {
+      std::lock_guard lock(mu_);
+      schedule_(now + options_.input_latency);
+    }
+    cv_.notify_all();
+  }
+
+  bool FramePacer::frame_due(time_point now) const {
+    std::lock_guard lock(mu_);
+    return pending_ && now >= due_;
+  }
+
+  bool FramePacer::pending() const {
+    std::lock_guard lock(mu_);
+    return pending_;
+  }
+
+  FramePacer::time_point FramePacer::deadline() const {
+    std::lock_guard lock(mu_);
+    return pending_ ? due_ : time_point::max();
+  }
+
+  void FramePacer::begin_frame(time_point now) {
+    std::lock_guard lock(mu_);
+    pending_    = false;
+    has_frame_  = true;
+    last_frame_ = now;
+    ++frames_;
+  }
+
+  bool FramePacer::wait(duration max_wait) {
+    std::unique_lock lock(mu_);
+    const time_point now = clock::now();
+    const time_point limit =
+        max_wait >= time_point::max() - now ? time_point::max()
+                                            : now + max_wait;
+    for (;;) {
+      const time_point t = clock::now();
+      if (pending_ && t >= due_)
+        return true;
+      const time_point until = pending_ ? std::min(due_, limit) : limit;
+      if (t >= until)
+        return false;
+      if (until == time_point::max()) {
+        cv_.wait(lock);
+      }
+      else {
+        cv_.wait_until(lock, until);
+      }
+    }
+  }
+
+  std::uint64_t FramePacer::frames() const {
+    std::lock_guard lock(mu_);
+    return frames_;
+  }
+
+  std::uint64_t FramePacer::coalesced() const {
+    std::lock_guard lock(mu_);
+    return requests_ - std::min(requests_, frames_);
+  }
+
+} // namespace glyph::render
@@ -0,0 +1,228 @@
+// glyph/render/output.cpp
+//
+// Byte arena growth and platform write backends.
+
+#include "glyph/render/output.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <ostream>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace glyph::render {
+
+  void OutputBuffer::grow_(std::size_t min_capacity) {
+    // Geometric growth; a frame's worth of bytes settles after a few frames.
+    std::size_t next = std::max<std::size_t>(capacity_ * 2, 4096);
+    next             = std::max(next, min_capacity);
+
+    std::unique_ptr<char[]> fresh(new char[next]);
+    if (size_ != 0) {
+      std::memcpy(fresh.get(), data_.get(), size_);
+    }
+    data_.swap(fresh);
+    capacity_ = next;
+  }
+
+  OstreamSink::OstreamSink(std::ostream &out) noexcept : out_(out) {
+  }
+
+  void OstreamSink::write(std::string_view bytes) {
+    out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+
+  void OstreamSink::flush() {
+    out_.flush();
+  }
+
+  FdSink::FdSink(int fd) noexcept : fd_(fd) {
+  }
+
+  void FdSink::write(std::string_view bytes) {
+    if (fd_ < 0) {
+      return;
+    }
+    const char *p   = bytes.data();
+    std::size_t len = bytes.size();
+    while (len > 0) {
+#if defined(_WIN32)
+      const int n = ::_write(fd_, p, static_cast<unsigned>(len));
+#else
+      const ssize_t n = ::write(fd_, p, len);
+#endif
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return;
+      }
+      p += n;
+      len -= static_cast<std::size_t>(n);
+    }
+  }
+
+  void FdSink::write_parts(std::span<const std::string_view> parts) {
+#if defined(_WIN32)
+    for (const auto part : parts) {
+      write(part);
+    }
+#else
+    if (fd_ < 0) {
+      return;
+    }
+
+    // Batch up to a fixed number of iovecs; frames use only a handful.
+    constexpr std::size_t kMaxIov = 16;
+    iovec                 iov[kMaxIov];
+
+    std::size_t i = 0;
+    while (i < parts.size()) {
+      int cnt = 0;
+      for (; i < parts.size() && std::size_t(cnt) < kMaxIov; ++i) {
+        if (parts[i].empty())
+          continue;
+        iov[cnt].iov_base = const_cast<char *>(parts[i].data());
+        iov[cnt].iov_len  = parts[i].size();
+        ++cnt;
+      }
+
+      int first = 0;
+      while (first < cnt) {
+        const ssize_t n = ::writev(fd_, iov + first, cnt - first);
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        if (n <= 0) {
+          return;
+        }
+
+        // Consume fully written iovecs, then trim a partially written one.
+        std::size_t left = static_cast<std::size_t>(n);
+        while (first < cnt && left >= iov[first].iov_len) {
+          left -= iov[first].iov_len;
+          ++first;
+        }
+        if (first < cnt && left > 0) {
+          iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + left;
+          iov[first].iov_len -= left;
+        }
+      }
+    }
+#endif
+  }
+
+  NonBlockingFdSink::NonBlockingFdSink(int fd) : fd_(fd) {
+#if !defined(_WIN32)
+    if (fd_ >= 0) {
+      old_flags_ = ::fcntl(fd_, F_GETFL);
+      if (old_flags_ >= 0 && (old_flags_ & O_NONBLOCK) == 0) {
+        ::fcntl(fd_, F_SETFL, old_flags_ | O_NONBLOCK);
+      }
+    }
+#endif
+  }
+
+  NonBlockingFdSink::~NonBlockingFdSink() {
+#if !defined(_WIN32)
+    // Deliver what is left, then hand the descriptor back as we found it.
+    if (fd_ >= 0 && old_flags_ >= 0) {
+      drain(1000);
+      ::fcntl(fd_, F_SETFL, old_flags_);
+    }
+#endif
+  }
+
+  std::size_t NonBlockingFdSink::write_some_(std::string_view bytes) {
+    std::size_t done = 0;
+    while (done < bytes.size()) {
+#if defined(_WIN32)
+      const int n = ::_write(fd_, bytes.data() + done,
+                             static_cast<unsigned>(bytes.size() - done));
+#else
+      const ssize_t n = ::write(fd_, bytes.data() + done, bytes.size() - done);
+#endif
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        // Hard error (EPIPE, EIO, ...): the rest can never be delivered.
+        // Drop it as FdSink would, so the sink does not look congested
+        // forever.
+        error_ = errno;
+        return bytes.size();
+      }
+      if (n <= 0) {
+        break; // full: keep the rest queued
+      }
+      done += static_cast<std::size_t>(n);
+    }
+    return done;
+  }
+
+  void NonBlockingFdSink::write(std::string_view bytes) {
+    if (fd_ < 0 || bytes.empty()) {
+      return;
+    }
+    flush();
+    if (bytes_outstanding() != 0) {
+      pending_.append(bytes); // keep ordering behind the queue
+      return;
+    }
+    const std::size_t n = write_some_(bytes);
+    if (n < bytes.size()) {
+      pending_.assign(bytes.substr(n));
+      head_ = 0;
+    }
+  }
+
+  void NonBlockingFdSink::write_parts(std::span<const std::string_view> parts) {
+    // Coalesce through the queue so a short write never splits ordering.
+    for (const auto part : parts) {
+      write(part);
+    }
+  }
+
+  void NonBlockingFdSink::flush() {
+    if (fd_ < 0 || bytes_outstanding() == 0) {
+      return;
+    }
+    head_ += write_some_(std::string_view{pending_}.substr(head_));
+    if (head_ == pending_.size()) {
+      pending_.clear(); // keeps capacity
+      head_ = 0;
+    }
+    else if (head_ > pending_.size() / 2) {
+      pending_.erase(0, head_);
+      head_ = 0;
+    }
+  }
+
+  bool NonBlockingFdSink::drain(int timeout_ms) {
+    flush();
+#if !defined(_WIN32)
+    while (bytes_outstanding() != 0) {
+      pollfd pfd{};
+      pfd.fd     = fd_;
+      pfd.events = POLLOUT;
+      const int r = ::poll(&pfd, 1, timeout_ms);
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      if (r <= 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+        break;
+      }
+      flush();
+    }
+#endif
+    return bytes_outstanding() == 0;
+  }
+
+} // namespace glyph::render
@@ -0,0 +1,76 @@
+// glyph/render/render_stats.cpp
+//
+// Rolling render statistics.
+
+#include "glyph/render/render_stats.h"
+
+#include <algorithm>
+
+namespace glyph::render {
+
+  std::uint64_t metric_value(const RenderStats &s, RenderMetric m) noexcept {
+    switch (m) {
+    case RenderMetric::DirtyLines:   return s.dirty_lines;
+    case RenderMetric::ChangedLines: return s.changed_lines;
+    case RenderMetric::Spans:        return s.spans;
+    case RenderMetric::Cells:        return s.cells;
+    case RenderMetric::SgrChanges:   return s.sgr_changes;
+    case RenderMetric::CursorMoves:  return s.cursor_moves;
+    case RenderMetric::Bytes:        return s.bytes;
+    case RenderMetric::DirtyNs:      return s.dirty_ns;
+    case RenderMetric::HashNs:       return s.hash_ns;
+    case RenderMetric::DiffNs:       return s.diff_ns;
+    case RenderMetric::EncodeNs:     return s.encode_ns;
+    case RenderMetric::WriteNs:      return s.write_ns;
+    case RenderMetric::TotalNs:      return s.total_ns();
+    }
+    return 0;
+  }
+
+  RenderStatsWindow::RenderStatsWindow(std::size_t capacity)
+      : ring_(std::make_unique<RenderStats[]>(std::max<std::size_t>(capacity, 1))),
+        scratch_(std::make_unique<std::uint64_t[]>(
+            std::max<std::size_t>(capacity, 1))),
+        capacity_(std::max<std::size_t>(capacity, 1)) {
+  }
+
+  void RenderStatsWindow::push(const RenderStats &s) noexcept {
+    ring_[head_] = s;
+    head_        = (head_ + 1) % capacity_;
+    count_       = std::min(count_ + 1, capacity_);
+    ++total_;
+  }
+
+  void RenderStatsWindow::clear() noexcept {
+    head_  = 0;
+    count_ = 0;
+    total_ = 0;
+  }
+
+  RenderStatsWindow::Summary
+  RenderStatsWindow::summarize(RenderMetric m) const noexcept {
+    Summary out{};
+    if (count_ == 0)
+      return out;
+
+    // The window holds the last count_ entries; order does not matter.
+    for (std::size_t i = 0; i < count_; ++i) {
+      scratch_[i] = metric_value(ring_[i], m);
+    }
+    std::uint64_t *first = scratch_.get();
+    std::uint64_t *last  = first + count_;
+
+    // Nearest-rank percentile: the ceil(p * n)-th smallest value.
+    auto rank = [&](std::size_t pct) {
+      const std::size_t k = (pct * count_ + 99) / 100;
+      std::uint64_t    *nth = first + (k == 0 ? 0 : k - 1);
+      std::nth_element(first, nth, last);
+      return *nth;
+    };
+    out.p50 = rank(50);
+    out.p99 = rank(99);
+    out.max = *std::max_element(first, last);
+    return out;
+  }
+
+} // namespace glyph::render
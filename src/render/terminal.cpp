@@ -6,8 +6,6 @@
 
 #include <ostream>
 
-#include "glyph/view/frame.h"
-
 #if defined(_WIN32)
 #include <windows.h>
 #else
@@ -69,6 +67,9 @@ namespace glyph::render {
     if (options_.hide_cursor) {
       out_ << "\x1b[?25l";
     }
+    if (options_.synchronized_output) {
+      out_ << kQuerySynchronizedOutput << std::flush;
+    }
   }
 
   TerminalSession::~TerminalSession() {
@@ -81,7 +82,26 @@ namespace glyph::render {
   }
 
   TerminalApp::TerminalApp(std::ostream &out, TerminalSessionOptions options)
-      : session_(out, options), renderer_(out) {
+      : session_(out, options), renderer_(out, options.renderer),
+        options_(options) {
+    if (options_.async_render) {
+      async_ = std::make_unique<AsyncRenderer>(tracked_);
+    }
+  }
+
+  void TerminalApp::TrackedRenderer_::render(const view::Frame &frame) {
+    app_.renderer_.render(frame);
+    app_.pending_.store(app_.renderer_.has_pending(),
+                        std::memory_order_relaxed);
+  }
+
+  template <class Fn> void TerminalApp::with_renderer_(Fn &&fn) {
+    if (async_) {
+      async_->post([this, fn] { fn(renderer_); });
+    }
+    else {
+      fn(renderer_);
+    }
   }
 
   TerminalSize TerminalApp::size() const {
@@ -93,11 +113,77 @@ namespace glyph::render {
   }
 
   void TerminalApp::render(const view::Frame &frame) {
-    renderer_.render(frame);
+    if (async_) {
+      async_->render(frame);
+    }
+    else {
+      renderer_.render(frame);
+    }
+  }
+
+  view::Frame &TerminalApp::begin_frame(const core::Cell &fill) {
+    return begin_frame(frame_size(), fill);
+  }
+
+  view::Frame &TerminalApp::begin_frame(core::Size        size,
+                                        const core::Cell &fill) {
+    if (frame_.size() != size) {
+      frame_.resize(size, fill);
+    }
+    else {
+      frame_.reset(fill);
+    }
+    return frame_;
+  }
+
+  void TerminalApp::end_frame() {
+    render(frame_);
+  }
+
+  bool TerminalApp::has_pending() const noexcept {
+    return async_ ? pending_.load(std::memory_order_relaxed)
+                  : renderer_.has_pending();
+  }
+
+  bool TerminalApp::render_pending() {
+    if (!async_)
+      return renderer_.render_pending();
+    if (!pending_.load(std::memory_order_relaxed))
+      return false;
+    // One queued call at a time: polling while has_pending() would
+    // otherwise queue a task per poll until the render thread gets to them.
+    if (!posted_.exchange(true, std::memory_order_acq_rel)) {
+      async_->post([this] {
+        posted_.store(false, std::memory_order_release);
+        renderer_.render_pending();
+        pending_.store(renderer_.has_pending(), std::memory_order_relaxed);
+      });
+    }
+    return true;
   }
 
   void TerminalApp::reset_renderer() {
-    renderer_.reset();
+    with_renderer_([](AnsiRenderer &r) { r.reset(); });
+  }
+
+  void TerminalApp::flush() {
+    if (async_) {
+      async_->flush();
+    }
+  }
+
+  bool TerminalApp::handle_event(const core::Event &ev) {
+    const auto *report = std::get_if<core::ModeReportEvent>(&ev);
+    if (!report)
+      return false;
+    if (report->dec_private && report->mode == kModeSynchronizedOutput) {
+      synchronized_output_ =
+          options_.synchronized_output && report->supported();
+      with_renderer_([on = synchronized_output_](AnsiRenderer &r) {
+        r.set_synchronized_output(on);
+      });
+    }
+    return true;
   }
 
 } // namespace glyph::render
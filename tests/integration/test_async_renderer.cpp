@@ -0,0 +1,131 @@
+// Integration tests for AsyncRenderer.
+//
+// A gated inner renderer holds the render thread inside render() so the
+// tests can publish frames while the writer is "stalled" and check that the
+// app thread never waits, that stale frames collapse, and that the changes
+// they carried still reach the terminal.
+
+#include <doctest/doctest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glyph/core/cell.h"
+#include "glyph/render/ansi/ansi_renderer.h"
+#include "glyph/render/async_renderer.h"
+#include "glyph/view/frame.h"
+
+using namespace glyph;
+
+namespace {
+  // Forwards to `next` once opened; records what each frame looked like.
+  class GatedRenderer final : public render::Renderer {
+  public:
+    explicit GatedRenderer(render::Renderer *next = nullptr) : next_(next) {
+    }
+
+    void render(const view::Frame &frame) override {
+      std::unique_lock lock(mu_);
+      entered_ = true;
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return open_; });
+      seen_.push_back(frame.at(0, 0).ch);
+      if (next_) {
+        next_->render(frame);
+      }
+    }
+
+    void wait_entered() {
+      std::unique_lock lock(mu_);
+      cv_.wait(lock, [this] { return entered_; });
+    }
+
+    void open() {
+      std::lock_guard lock(mu_);
+      open_ = true;
+      cv_.notify_all();
+    }
+
+    std::vector<char32_t> seen() {
+      std::lock_guard lock(mu_);
+      return seen_;
+    }
+
+  private:
+    render::Renderer       *next_;
+    std::mutex              mu_;
+    std::condition_variable cv_;
+    bool                    entered_ = false;
+    bool                    open_    = false;
+    std::vector<char32_t>   seen_{};
+  };
+} // namespace
+
+TEST_CASE("frames published during a stalled write collapse into the latest") {
+  GatedRenderer         gate;
+  render::AsyncRenderer async{gate};
+
+  view::Frame frame{core::Size{4, 2}};
+  frame.set(core::Point{0, 0}, core::Cell::from_char(U'1'));
+  async.render(frame);
+  gate.wait_entered(); // writer is now blocked on "terminal IO"
+
+  // None of these wait for the writer.
+  for (char32_t ch : {U'2', U'3', U'4', U'5'}) {
+    frame.set(core::Point{0, 0}, core::Cell::from_char(ch));
+    async.render(frame);
+  }
+
+  gate.open();
+  async.flush();
+
+  CHECK(gate.seen() == std::vector<char32_t>{U'1', U'5'});
+  const auto stats = async.stats();
+  CHECK(stats.published == 5);
+  CHECK(stats.rendered == 2);
+  CHECK(stats.collapsed == 3);
+}
+
+TEST_CASE("changes carried by collapsed frames still reach the terminal") {
+  std::ostringstream    os;
+  render::AnsiRenderer  ansi{os};
+  GatedRenderer         gate{&ansi};
+  render::AsyncRenderer async{gate};
+
+  // A reused frame: only rows touched since the last publish are dirty.
+  view::Frame frame{core::Size{8, 12}, core::Cell::from_char(U'.')};
+  async.render(frame);
+  gate.wait_entered();
+
+  frame.set(core::Point{3, 2}, core::Cell::from_char(U'X')); // collapsed
+  async.render(frame);
+  frame.set(core::Point{5, 9}, core::Cell::from_char(U'Y'));
+  async.render(frame);
+
+  gate.open();
+  async.flush();
+
+  const std::string out = os.str();
+  CHECK(out.find('X') != std::string::npos);
+  CHECK(out.find('Y') != std::string::npos);
+  CHECK(async.stats().collapsed == 1);
+}
+
+TEST_CASE("posted tasks run on the render thread before the next frame") {
+  std::ostringstream    os;
+  render::AnsiRenderer  ansi{os};
+  render::AsyncRenderer async{ansi};
+
+  view::Frame frame{core::Size{4, 1}, core::Cell::from_char(U'a')};
+  async.render(frame);
+  async.flush();
+  const std::size_t first = os.str().size();
+
+  async.post([&] { ansi.reset(); });
+  async.render(frame); // unchanged, but reset forces a full redraw
+  async.flush();
+  CHECK(os.str().substr(first).find("aaaa") != std::string::npos);
+}
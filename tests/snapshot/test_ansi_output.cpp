@@ -7,13 +7,23 @@
 
 #include <doctest/doctest.h>
 
+#include <chrono>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "glyph/core/cell.h"
 #include "glyph/core/geometry.h"
 #include "glyph/render/ansi/ansi_renderer.h"
+#include "glyph/render/ansi/cursor_motion.h"
+#include "glyph/render/terminal.h"
 #include "glyph/view/frame.h"
+#include "glyph/view/text.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace glyph;
 
@@ -174,3 +184,706 @@ TEST_CASE("no cursor hint hides the hardware cursor") {
 
   CHECK(contains(os.str(), "\x1b[?25l"));
 }
+
+TEST_CASE("spans on one row use relative moves and re-print short gaps") {
+  std::ostringstream os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{40, 1}};
+  frame.fill(core::Cell::from_char(U'.'));
+  r.render(frame);
+  const std::size_t mark = os.str().size();
+
+  (void)frame.take_dirty_lines();
+  frame.set(core::Point{5, 0}, core::Cell::from_char(U'A'));
+  frame.set(core::Point{8, 0}, core::Cell::from_char(U'B'));
+  frame.set(core::Point{20, 0}, core::Cell::from_char(U'C'));
+  r.render(frame);
+
+  // The frame opens with a CUP (the cursor is not trusted across frames),
+  // a two-cell gap is re-printed instead of moving, then a horizontal jump
+  // over the long gap (CHA ties CUF and wins as absolute). No full CUP for
+  // the later spans.
+  const std::string inc = os.str().substr(mark);
+  CHECK(contains(inc, "\x1b[1;6HA..B\x1b[21GC"));
+  CHECK_FALSE(contains(inc, ";9H"));
+  CHECK_FALSE(contains(inc, ";21H"));
+}
+
+TEST_CASE("output between frames does not throw off the next frame's moves") {
+  std::ostringstream os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{40, 3}};
+  frame.fill(core::Cell::from_char(U'.'));
+  frame.set_cursor(core::Point{4, 0});
+  r.render(frame);
+
+  // Someone else writes to the terminal: the cursor is no longer at (4, 0).
+  os << "log line\r\n";
+  const std::size_t mark = os.str().size();
+
+  (void)frame.take_dirty_lines();
+  frame.set(core::Point{5, 0}, core::Cell::from_char(U'A'));
+  r.render(frame);
+
+  // Relative to (4, 0) this would be a bare CUF; it must be absolute.
+  const std::string inc = os.str().substr(mark);
+  CHECK(contains(inc, "\x1b[1;6HA"));
+  CHECK_FALSE(contains(inc, "\x1b[CA"));
+}
+
+TEST_CASE("full redraw clears and skips default blanks") {
+  std::ostringstream os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{200, 50}};
+  view::draw_text(frame, core::Point{10, 20}, "hello");
+  for (core::coord_t x = 150; x < 200; ++x) {
+    frame.set(core::Point{x, 30},
+              core::Cell::from_char(U' ', core::Style::with_bg(0x203040)));
+  }
+  r.render(frame);
+
+  const std::string out = os.str();
+  CHECK(contains(out, "\x1b[2J"));
+  CHECK(contains(out, "\x1b[21;11Hhello"));
+  // The coloured tail of row 31 is erased, not printed.
+  CHECK(contains(out, "\x1b[K"));
+  CHECK(r.last_stats().full_redraw);
+  CHECK(r.last_stats().spans == 2);
+  CHECK(out.size() < 100);
+}
+
+TEST_CASE("full redraw advances rows with CR+LF") {
+  std::ostringstream os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{3, 2}};
+  frame.fill(core::Cell::from_char(U'x'));
+  r.render(frame);
+
+  CHECK(contains(os.str(), "xxx\r\nxxx"));
+}
+
+TEST_CASE("cursor motion picks the cheapest sequence") {
+  auto move = [](render::CursorState from, core::Point to) {
+    render::OutputBuffer b;
+    render::encode_cursor_move(b, from, to);
+    return std::string{b.view()};
+  };
+  const auto at = [](core::coord_t x, core::coord_t y) {
+    return render::CursorState::known_at(core::Point{x, y});
+  };
+
+  CHECK(move(render::CursorState::unknown(), {4, 9}) == "\x1b[10;5H");
+  CHECK(move(at(3, 2), {3, 2}).empty());
+  CHECK(move(at(3, 2), {4, 2}) == "\x1b[C");
+  CHECK(move(at(7, 2), {0, 2}) == "\r");
+  CHECK(move(at(7, 2), {0, 3}) == "\r\n");
+  CHECK(move(at(7, 2), {7, 1}) == "\x1b[A");
+  CHECK(render::cursor_move_cost(at(0, 0), {0, 0}) == 0);
+}
+
+TEST_CASE("a log pane shifted up by one line scrolls instead of repainting") {
+  auto log_frame = [](int first) {
+    view::Frame f{core::Size{12, 10}};
+    f.fill(core::Cell::from_char(U' '));
+    for (core::coord_t y = 0; y < 10; ++y) {
+      const std::u32string text = U"line " + std::u32string(1, U'A' + first + y);
+      for (core::coord_t x = 0; x < core::coord_t(text.size()); ++x)
+        f.set(core::Point{x, y}, core::Cell::from_char(text[std::size_t(x)]));
+    }
+    return f;
+  };
+
+  std::ostringstream os;
+  render::AnsiRenderer r{os};
+  r.render(log_frame(0));
+  const std::size_t mark = os.str().size();
+
+  r.render(log_frame(1));
+  const std::string inc = os.str().substr(mark);
+
+  // Scroll region over the pane, scroll up one, restore margins.
+  CHECK(contains(inc, "\x1b[1;10r\x1b[S\x1b[r"));
+  // Only the newly exposed bottom row is painted.
+  CHECK(contains(inc, "line K"));
+  CHECK_FALSE(contains(inc, "line F"));
+}
+
+TEST_CASE("synchronized output brackets each frame") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{
+      os, render::AnsiRendererOptions{.synchronized_output = true}};
+  view::Frame f{core::Size{4, 2}};
+  f.set(core::Point{0, 0}, core::Cell::from_char(U'A'));
+  r.render(f);
+  const std::string out = os.str();
+  CHECK(out.rfind("\x1b[?2026h", 0) == 0);
+  CHECK(out.size() >= 8);
+  CHECK(out.substr(out.size() - 8) == "\x1b[?2026l");
+}
+
+TEST_CASE("TerminalApp enables synchronized output only on a positive reply") {
+  std::ostringstream  os;
+  render::TerminalApp app{
+      os, render::TerminalSessionOptions{.use_alt_screen      = false,
+                                         .hide_cursor         = false,
+                                         .synchronized_output = true}};
+  CHECK(os.str() == render::kQuerySynchronizedOutput);
+  CHECK_FALSE(app.synchronized_output());
+
+  CHECK_FALSE(app.handle_event(core::KeyEvent{}));
+  CHECK(app.handle_event(core::ModeReportEvent{
+      .mode = 2026, .state = core::ModeState::NotRecognized}));
+  CHECK_FALSE(app.synchronized_output());
+  CHECK(app.handle_event(
+      core::ModeReportEvent{.mode = 2026, .state = core::ModeState::Reset}));
+  CHECK(app.synchronized_output());
+
+  os.str("");
+  view::Frame f{core::Size{3, 1}};
+  app.render(f);
+  CHECK(contains(os.str(), "\x1b[?2026h"));
+  CHECK(contains(os.str(), "\x1b[?2026l"));
+}
+
+TEST_CASE("TerminalApp recycles one frame across begin/end_frame") {
+  std::ostringstream  os;
+  render::TerminalApp app{
+      os, render::TerminalSessionOptions{.use_alt_screen = false,
+                                         .hide_cursor    = false}};
+
+  auto &first = app.begin_frame(core::Size{8, 3});
+  view::draw_text(first, core::Point{0, 1}, "abc");
+  first.set_cursor(core::Point{3, 1});
+  app.end_frame();
+  CHECK(contains(os.str(), "abc"));
+
+  // Same frame back, blank again, cursor hint dropped.
+  auto &second = app.begin_frame(core::Size{8, 3});
+  CHECK(&second == &first);
+  CHECK(second.at(0, 1) == core::Cell{});
+  CHECK_FALSE(second.cursor().visible);
+  CHECK(second.has_dirty_lines()); // row 1, cleared by the reset
+  view::draw_text(second, core::Point{0, 2}, "xyz");
+  const std::size_t mark = os.str().size();
+  app.end_frame();
+  CHECK(contains(os.str().substr(mark), "xyz"));
+  CHECK_FALSE(contains(os.str().substr(mark), "abc"));
+
+  auto &bigger = app.begin_frame(core::Size{10, 4});
+  CHECK(bigger.size() == core::Size{10, 4});
+  CHECK(bigger.at(0, 2) == core::Cell{});
+}
+
+TEST_CASE("clearing a wide row costs an erase, not a row of spaces") {
+  constexpr core::coord_t kW = 300;
+  std::ostringstream      os;
+  render::AnsiRenderer    r{os};
+
+  view::Frame frame{core::Size{kW, 2}};
+  frame.fill(core::Cell::from_char(U'#'));
+  r.render(frame);
+  const std::size_t after_first = os.str().size();
+
+  view::Frame frame2{core::Size{kW, 2}};
+  frame2.fill(core::Cell::from_char(U'#'));
+  for (core::coord_t x = 0; x < kW; ++x) {
+    frame2.set(core::Point{x, 1}, core::Cell::from_char(U' '));
+  }
+  r.render(frame2);
+
+  const std::string inc = os.str().substr(after_first);
+  CHECK(contains(inc, "\x1b[2H\x1b[K"));
+  CHECK(inc.find(' ') == std::string::npos);
+  CHECK(inc.size() < 24);
+}
+
+TEST_CASE("interior blank runs use ECH and skip past the run") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  view::Frame          frame{core::Size{30, 1}};
+  const core::Style    bg = core::Style{}.bg(0x202020);
+  for (core::coord_t x = 0; x < 30; ++x) {
+    frame.set(core::Point{x, 0}, core::Cell::from_char(U' ', bg));
+  }
+  frame.set(core::Point{0, 0}, core::Cell::from_char(U'a', bg));
+  frame.set(core::Point{29, 0}, core::Cell::from_char(U'b', bg));
+  r.render(frame);
+
+  const std::string out = os.str();
+  CHECK(contains(out, "a\x1b[28X\x1b[30Gb"));
+}
+
+TEST_CASE("underlined blanks are printed, not erased") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  view::Frame          frame{core::Size{12, 1}};
+  frame.fill(core::Cell::from_char(U' ', core::Style{}.underline()));
+  r.render(frame);
+  CHECK_FALSE(contains(os.str(), "\x1b[K"));
+  CHECK(contains(os.str(), std::string(12, ' ')));
+}
+
+TEST_CASE("repeated glyphs use REP when enabled") {
+  view::Frame frame{core::Size{40, 1}};
+  frame.fill(core::Cell::from_char(U'─'));
+
+  std::ostringstream   plain_os;
+  render::AnsiRenderer plain{plain_os};
+  plain.render(frame);
+
+  std::ostringstream   rep_os;
+  render::AnsiRenderer rep{
+      rep_os, render::AnsiRendererOptions{.repeat_glyphs = true}};
+  rep.render(frame);
+
+  CHECK(contains(rep_os.str(), "─\x1b[39b"));
+  CHECK(rep_os.str().size() + 100 < plain_os.str().size());
+}
+
+#if !defined(_WIN32)
+TEST_CASE("a congested sink skips frames and converges in one update") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  std::string got;
+  auto        read_all = [&](render::NonBlockingFdSink &sink) {
+    char tmp[4096];
+    for (;;) {
+      const auto n = ::read(fds[0], tmp, sizeof(tmp));
+      if (n > 0) {
+        got.append(tmp, std::size_t(n));
+      }
+      sink.flush();
+      if (n <= 0 && sink.bytes_outstanding() == 0)
+        break;
+    }
+  };
+
+  {
+    render::NonBlockingFdSink sink{fds[1]};
+    render::AnsiRenderer      r{sink};
+
+    // One full redraw larger than the pipe buffer.
+    view::Frame frame{core::Size{400, 200}, core::Cell::from_char(U'.')};
+    r.render(frame);
+    REQUIRE(r.bytes_outstanding() > 0);
+
+    // Updates while the link is congested are dropped, not queued.
+    frame.set(core::Point{3, 2}, core::Cell::from_char(U'X'));
+    r.render(frame);
+    frame.set(core::Point{5, 9}, core::Cell::from_char(U'Y'));
+    r.render(frame);
+    CHECK(r.frames_skipped() == 2);
+
+    read_all(sink);
+    const std::size_t drained = got.size();
+
+    // Only row 11 is dirty, but the skipped changes still go out.
+    frame.set(core::Point{7, 11}, core::Cell::from_char(U'Z'));
+    r.render(frame);
+    read_all(sink);
+
+    const std::string update = got.substr(drained);
+    CHECK(contains(update, "X"));
+    CHECK(contains(update, "Y"));
+    CHECK(contains(update, "Z"));
+    CHECK(update.size() < 100);
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("a skipped frame is kept and drawn by render_pending") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  std::string got;
+  auto        read_pipe = [&] {
+    char tmp[4096];
+    for (ssize_t n; (n = ::read(fds[0], tmp, sizeof(tmp))) > 0;) {
+      got.append(tmp, std::size_t(n));
+    }
+  };
+
+  {
+    render::NonBlockingFdSink sink{fds[1]};
+    render::AnsiRenderer      r{sink};
+
+    view::Frame frame{core::Size{400, 200}, core::Cell::from_char(U'.')};
+    r.render(frame);
+    REQUIRE(r.bytes_outstanding() > 0);
+
+    // The last state the app renders arrives while the link is congested.
+    frame.set(core::Point{3, 2}, core::Cell::from_char(U'X'));
+    r.render(frame);
+    CHECK(r.frames_skipped() == 1);
+    CHECK(r.has_pending());
+
+    // The terminal catches up; the app renders nothing new.
+    while (r.has_pending()) {
+      read_pipe();
+      r.render_pending();
+    }
+    read_pipe();
+
+    CHECK(r.bytes_outstanding() == 0);
+    CHECK(got.find('X') != std::string::npos);
+    CHECK_FALSE(r.render_pending());
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+#endif
+
+namespace {
+  // Fill row y with the single character base + y, so every row (and every
+  // frame built from a different base) is distinguishable in the output.
+  void write_rows(view::Frame &f, int base) {
+    for (core::coord_t y = 0; y < f.size().h; ++y) {
+      for (core::coord_t x = 0; x < f.size().w; ++x) {
+        f.set(core::Point{x, y}, core::Cell::from_char(char32_t(base + y)));
+      }
+    }
+  }
+
+  std::string row_text(const view::Frame &f, int base, core::coord_t y) {
+    return std::string(std::size_t(f.size().w), char(base + y));
+  }
+
+  constexpr int kBaseA = '!'; // rows '!'..'H'
+  constexpr int kBaseB = 'I'; // rows 'I'..'p'
+} // namespace
+
+TEST_CASE("a byte budget spreads a full redraw over several ticks") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os, render::AnsiRendererOptions{.byte_budget = 2048}};
+  view::Frame          frame{core::Size{120, 40}};
+  write_rows(frame, kBaseA);
+
+  r.render(frame);
+  const std::size_t first = os.str().size();
+  CHECK(contains(os.str(), "\x1b[2J"));
+  CHECK(first < 2048 + 200); // budget plus one row
+  CHECK(r.has_pending());
+
+  int ticks = 1;
+  while (r.has_pending()) {
+    r.render_pending();
+    ++ticks;
+    REQUIRE(ticks < 100);
+  }
+  CHECK(ticks >= 3);
+
+  // Every row went out, and nothing is left to send.
+  for (core::coord_t y = 0; y < 40; ++y) {
+    CHECK(contains(os.str(), row_text(frame, kBaseA, y)));
+  }
+  const std::size_t done = os.str().size();
+  (void)frame.take_dirty_lines();
+  r.render(frame);
+  CHECK(os.str().size() == done);
+}
+
+TEST_CASE("budgeted frames send the priority region first") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os, render::AnsiRendererOptions{.byte_budget = 1024}};
+  view::Frame          frame{core::Size{120, 40}};
+  write_rows(frame, kBaseA);
+  r.render(frame);
+  while (r.render_pending()) {
+  }
+
+  r.set_priority_region(core::Rect{0, 30, 120, 4});
+  write_rows(frame, kBaseB);
+  const std::size_t before = os.str().size();
+  r.render(frame);
+  const std::string tick = os.str().substr(before);
+  const auto focus = tick.find(row_text(frame, kBaseB, 30));
+  REQUIRE(focus != std::string::npos);
+  CHECK(contains(tick, row_text(frame, kBaseB, 33)));
+  // Then the rest in row order, until the budget runs out.
+  CHECK(focus < tick.find(row_text(frame, kBaseB, 0)));
+  CHECK_FALSE(contains(tick, row_text(frame, kBaseB, 39)));
+  CHECK(r.has_pending());
+}
+
+TEST_CASE("rows left pending survive a newer frame") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os, render::AnsiRendererOptions{.byte_budget = 1024}};
+  view::Frame          frame{core::Size{120, 40}};
+  write_rows(frame, kBaseA);
+  r.render(frame);
+  while (r.render_pending()) {
+  }
+
+  write_rows(frame, kBaseB);
+  r.render(frame); // truncated
+  REQUIRE(r.has_pending());
+
+  // The next frame only touches row 0; the rest still converges.
+  (void)frame.take_dirty_lines();
+  frame.set(core::Point{0, 0}, core::Cell::from_char(U'#'));
+  const std::size_t before = os.str().size();
+  r.render(frame);
+  while (r.render_pending()) {
+  }
+  const std::string rest = os.str().substr(before);
+  CHECK(contains(rest, row_text(frame, kBaseB, 39)));
+  CHECK_FALSE(r.has_pending());
+}
+
+TEST_CASE("render stats count the work of each frame") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  view::Frame          frame{core::Size{10, 4}};
+  frame.fill(core::Cell::from_char(U'.'));
+  r.render(frame);
+
+  const auto &first = r.last_stats();
+  CHECK(first.full_redraw);
+  CHECK(first.spans == 4);
+  CHECK(first.cells == 40);
+  CHECK(first.bytes == os.str().size());
+
+  (void)frame.take_dirty_lines();
+  frame.set(core::Point{3, 2}, core::Cell::from_char(U'Z'));
+  const std::size_t before = os.str().size();
+  r.render(frame);
+
+  const auto &inc = r.last_stats();
+  CHECK_FALSE(inc.full_redraw);
+  CHECK(inc.dirty_lines == 1);
+  CHECK(inc.changed_lines == 1);
+  CHECK(inc.spans == 1);
+  CHECK(inc.cells == 1);
+  CHECK(inc.cursor_moves == 1);
+  CHECK(inc.sgr_changes == 0);
+  CHECK(inc.bytes == os.str().size() - before);
+
+  CHECK(r.stats_window().size() == 2);
+  CHECK(r.stats_window().summarize(render::RenderMetric::Spans).max == 4);
+}
+
+TEST_CASE("running out of style ids keeps the shadow and the diff") {
+  // More distinct styles than a StyleTable can number.
+  const core::Size size{300, 220};
+  view::Frame      frame{size};
+  for (core::coord_t y = 0; y < size.h; ++y) {
+    for (core::coord_t x = 0; x < size.w; ++x) {
+      const auto rgb = std::uint32_t(y * size.w + x);
+      frame.set(core::Point{x, y},
+                core::Cell::from_char(U'x', core::Style::with_fg(rgb)));
+    }
+  }
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  CHECK(r.last_stats().full_redraw);
+
+  // Ids only key the SGR cache: the shadow survives, so an unchanged frame
+  // costs nothing...
+  (void)frame.take_dirty_lines();
+  r.render(frame);
+  CHECK_FALSE(r.last_stats().full_redraw);
+  CHECK(r.last_stats().cells == 0);
+
+  // ...and a change is one cell, whatever the state of the table.
+  const std::size_t mark = os.str().size();
+  frame.set(core::Point{299, 219},
+            core::Cell::from_char(U'#', core::Style::with_fg(0x00FF00)));
+  r.render(frame);
+  CHECK_FALSE(r.last_stats().full_redraw);
+  CHECK(r.last_stats().cells == 1);
+  CHECK(contains(os.str().substr(mark), "#"));
+}
+
+TEST_CASE("grapheme clusters are emitted whole and diffed by content") {
+  // 👩‍💻 (woman, ZWJ, laptop) as one wide cell followed by 'a'.
+  const std::u32string text = U"\U0001F469\u200D\U0001F4BBa";
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{6, 1}};
+  frame.fill(core::Cell::from_char(U' '));
+  view::draw_text(frame, core::Point{0, 0}, text);
+  r.render(frame);
+  CHECK(contains(os.str(), "\xF0\x9F\x91\xA9\xE2\x80\x8D\xF0\x9F\x92\xBB"
+                           "a"));
+
+  // Redrawing the same cluster into a fresh pool is not a change.
+  const std::size_t mark = os.str().size();
+  frame.fill(core::Cell::from_char(U' '));
+  view::draw_text(frame, core::Point{0, 0}, text);
+  r.render(frame);
+  CHECK(r.last_stats().cells == 0);
+  CHECK_FALSE(contains(os.str().substr(mark), "\xF0\x9F\x91\xA9"));
+}
+
+TEST_CASE("a cluster tag reused for other bytes is not diffed as equal") {
+  // Two clusters whose 31-bit tags collide, drawn in consecutive frames.
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+
+  view::Frame frame{core::Size{6, 1}};
+  frame.fill(core::Cell::from_char(U' '));
+  view::draw_text(frame, core::Point{0, 0}, std::u32string{U"b\u033F\u0323"});
+  r.render(frame);
+  const char32_t first = frame.buffer().const_view().at(0, 0).ch;
+
+  const std::size_t mark = os.str().size();
+  frame.fill(core::Cell::from_char(U' '));
+  view::draw_text(frame, core::Point{0, 0}, std::u32string{U"b\u036C\u0369"});
+  REQUIRE(frame.buffer().const_view().at(0, 0).ch == first);
+  r.render(frame);
+
+  // b U+036C U+0369 in UTF-8.
+  CHECK(contains(os.str().substr(mark), "b\xCD\xAC\xCD\xA9"));
+}
+
+TEST_CASE("clusters that left the screen are pruned from the shadow") {
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  view::Frame          frame{core::Size{4, 1}};
+
+  // A cell cycling through 2900 distinct clusters, one per frame, while
+  // another cell keeps showing the same one.
+  std::u32string cluster = U"a\u0300\u0300";
+  for (char32_t i = 0; i < 2900; ++i) {
+    cluster[0] = U'a' + i % 26;
+    cluster[1] = U'\u0300' + (i / 26) % 112;
+    frame.fill(core::Cell::from_char(U' '));
+    view::draw_text(frame, core::Point{0, 0}, cluster);
+    view::draw_text(frame, core::Point{2, 0}, std::u32string{U"e\u0301"});
+    r.render(frame);
+    REQUIRE(r.last_stats().full_redraw == (i == 0));
+  }
+
+  // The kept cluster still diffs as unchanged; the cycling one as new.
+  const std::size_t mark = os.str().size();
+  frame.fill(core::Cell::from_char(U' '));
+  view::draw_text(frame, core::Point{0, 0}, std::u32string{U"z\u0301"});
+  view::draw_text(frame, core::Point{2, 0}, std::u32string{U"e\u0301"});
+  r.render(frame);
+  CHECK(r.last_stats().cells == 1);
+  CHECK(contains(os.str().substr(mark), "z\xCC\x81"));
+}
+
+TEST_CASE("a one-cell update diffs only the written columns") {
+  const core::Size size{300, 6};
+  view::Frame      frame{size};
+  frame.fill(core::Cell::from_char(U'-'));
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  (void)frame.take_dirty_lines();
+
+  // A spinner drawn through a canvas: rows and columns are canvas-local.
+  auto canvas = frame.canvas(core::Rect{200, 4, 10, 1});
+  canvas.set(core::Point{3, 0}, core::Cell::from_char(U'|'));
+  const std::size_t mark = os.str().size();
+  r.render(frame);
+
+  const auto &stats = r.last_stats();
+  CHECK(stats.dirty_lines == 1);
+  CHECK(stats.cells == 1);
+  // Row 5, column 204 (1-based) receives the glyph.
+  CHECK(contains(os.str().substr(mark), "\x1b[5;204H|"));
+}
+
+TEST_CASE("canvas fills mark their rows dirty") {
+  view::Frame frame{core::Size{8, 4}};
+  frame.fill(core::Cell::from_char(U' '));
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  (void)frame.take_dirty_lines();
+  CHECK_FALSE(frame.has_dirty_lines());
+
+  auto canvas = frame.canvas(core::Rect{2, 1, 4, 3});
+  canvas.fill_rect(core::Rect{1, 1, 2, 1}, core::Cell::from_char(U'#'));
+  CHECK(frame.has_dirty_lines());
+  r.render(frame);
+  CHECK(r.last_stats().dirty_lines == 1);
+  CHECK(r.last_stats().cells == 2);
+
+  canvas.fill(core::Cell::from_char(U'.'));
+  r.render(frame);
+  CHECK(r.last_stats().dirty_lines == 3);
+  CHECK(r.last_stats().cells == 12);
+}
+
+TEST_CASE("the shadow tracks span-only updates across frames") {
+  const core::Size size{40, 4};
+  view::Frame      frame{size};
+  frame.fill(core::Cell::from_char(U'.'));
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  (void)frame.take_dirty_lines();
+
+  frame.set(core::Point{5, 1}, core::Cell::from_char(U'a'));
+  r.render(frame);
+  frame.set(core::Point{30, 1}, core::Cell::from_char(U'b'));
+  r.render(frame);
+  CHECK(r.last_stats().cells == 1);
+
+  // Undoing the first write must still repaint it: the shadow kept 'a'.
+  frame.set(core::Point{5, 1}, core::Cell::from_char(U'.'));
+  std::size_t mark = os.str().size();
+  r.render(frame);
+  CHECK(r.last_stats().cells == 1);
+  CHECK(contains(os.str().substr(mark), "."));
+
+  // A fresh frame with the same content changes nothing on screen.
+  view::Frame same{size};
+  same.fill(core::Cell::from_char(U'.'));
+  same.set(core::Point{30, 1}, core::Cell::from_char(U'b'));
+  mark = os.str().size();
+  r.render(same);
+  CHECK(r.last_stats().dirty_lines == 4);
+  CHECK(r.last_stats().changed_lines == 0);
+  CHECK(r.last_stats().cells == 0);
+}
+
+TEST_CASE("resize_debounce redraws once the size settles") {
+  using namespace std::chrono_literals;
+  std::ostringstream   os;
+  render::AnsiRenderer r{
+      os, render::AnsiRendererOptions{.resize_debounce = 40ms}};
+
+  view::Frame first{core::Size{10, 3}};
+  first.fill(core::Cell::from_char(U'a'));
+  r.render(first);
+  CHECK_FALSE(r.has_pending());
+
+  // A drag: two sizes in quick succession, neither drawn.
+  const std::size_t mark = os.str().size();
+  for (const core::coord_t w : {12, 14}) {
+    view::Frame step{core::Size{w, 3}};
+    step.fill(core::Cell::from_char(char32_t(U'A' + w)));
+    r.render(step);
+    CHECK(r.last_stats().skipped);
+    CHECK(r.has_pending());
+  }
+  CHECK(os.str().size() == mark);
+
+  CHECK(r.render_pending()); // still inside the quiet period
+  std::this_thread::sleep_for(60ms);
+  CHECK_FALSE(r.render_pending());
+  CHECK(r.last_stats().full_redraw);
+  const std::string out = os.str().substr(mark);
+  CHECK(contains(out, std::string(14, char('A' + 14))));
+  CHECK_FALSE(contains(out, std::string(1, char('A' + 12))));
+
+  // The held frame is now the shadow: the same content draws nothing.
+  view::Frame same{core::Size{14, 3}};
+  same.fill(core::Cell::from_char(char32_t(U'A' + 14)));
+  r.render(same);
+  CHECK(r.last_stats().cells == 0);
+}
@@ -0,0 +1,266 @@
+// Snapshot tests for delta SGR encoding.
+//
+// Pins the exact bytes of common pen transitions and measures the SGR
+// bytes saved on a colorful row compared with "reset + set" per change.
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glyph/core/cell.h"
+#include "glyph/core/style.h"
+#include "glyph/core/style_table.h"
+#include "glyph/render/ansi/ansi_renderer.h"
+#include "glyph/render/ansi/sgr.h"
+#include "glyph/render/ansi/sgr_cache.h"
+#include "glyph/view/frame.h"
+
+using namespace glyph;
+using core::Style;
+
+namespace {
+  using render::ColorMode;
+
+  std::string transition(const Style &from,
+                         const Style &to,
+                         ColorMode    mode = ColorMode::TrueColor) {
+    render::OutputBuffer b;
+    render::encode_sgr_transition(b, from, to, mode);
+    return std::string{b.view()};
+  }
+
+  std::string full(const Style &s, ColorMode mode = ColorMode::TrueColor) {
+    render::OutputBuffer b;
+    render::encode_sgr(b, s, mode);
+    return std::string{b.view()};
+  }
+} // namespace
+
+TEST_CASE("full SGR relies on the reset for default colors") {
+  CHECK(full(Style{}) == "\x1b[0m");
+  CHECK(full(Style{}.bold().fg(0x102030)) == "\x1b[0;1;38;2;16;32;48m");
+}
+
+TEST_CASE("foreground-only change emits just the foreground") {
+  const Style a = Style{}.fg(0xFF0010).bg(0x000010);
+  const Style b = Style{}.fg(0x0000FE).bg(0x000010);
+  CHECK(transition(a, b) == "\x1b[38;2;0;0;254m");
+}
+
+TEST_CASE("turning an attribute off uses its reset code") {
+  const Style base = Style{}.fg(0x336699);
+  CHECK(transition(Style{base}.italic(), base) == "\x1b[23m");
+  CHECK(transition(Style{base}.underline(), base) == "\x1b[24m");
+  // 22 clears both bold and dim; dim must be re-enabled.
+  CHECK(transition(Style{base}.bold().dim(), Style{base}.dim()) ==
+        "\x1b[22;2m");
+}
+
+TEST_CASE("returning to a default color emits 39/49") {
+  const Style bold = Style{}.bold();
+  CHECK(transition(Style{bold}.fg(0x123456), bold) == "\x1b[39m");
+  CHECK(transition(Style{bold}.bg(0x123456), bold) == "\x1b[49m");
+  // With nothing else set, a bare reset is one byte shorter.
+  CHECK(transition(Style{}.fg(0x123456), Style{}) == "\x1b[0m");
+}
+
+TEST_CASE("reset + set is chosen when it is shorter than the delta") {
+  const Style busy = Style{}.bold().italic().underline().blink().strike();
+  CHECK(transition(busy, Style{}) == "\x1b[0m");
+}
+
+TEST_CASE("identical pens emit nothing") {
+  Style a = Style{}.fg(0x010203);
+  Style b = a;
+  b.default_fg(); // rgb stays stored but is ignored by the pen
+  Style c = Style{};
+  CHECK(transition(a, a).empty());
+  CHECK(transition(b, c).empty());
+}
+
+TEST_CASE("exact palette colors use the short codes in true-color mode") {
+  CHECK(full(Style{}.fg(0x800000)) == "\x1b[0;31m");
+  CHECK(full(Style{}.fg(0xFF0000)) == "\x1b[0;91m");
+  CHECK(full(Style{}.bg(0x000080)) == "\x1b[0;44m");
+  CHECK(full(Style{}.bg(0xFFFFFF)) == "\x1b[0;107m");
+  CHECK(full(Style{}.fg(0x5F87AF)) == "\x1b[0;38;5;67m");  // cube
+  CHECK(full(Style{}.fg(0x121212)) == "\x1b[0;38;5;233m"); // gray ramp
+  CHECK(full(Style{}.fg(0x5F87AE)) == "\x1b[0;38;2;95;135;174m");
+}
+
+TEST_CASE("palette modes quantize to the nearest entry") {
+  CHECK(full(Style{}.fg(0xFA0505), ColorMode::Palette256) ==
+        "\x1b[0;38;5;196m");
+  CHECK(full(Style{}.fg(0x0A0A0A), ColorMode::Palette256) ==
+        "\x1b[0;38;5;232m");
+  CHECK(full(Style{}.fg(0xE01010), ColorMode::Palette16) == "\x1b[0;91m");
+  CHECK(full(Style{}.bg(0x101018), ColorMode::Palette16) == "\x1b[0;40m");
+
+  // Distinct colors that land on the same palette entry need no transition.
+  CHECK(transition(Style{}.fg(0xF00000), Style{}.fg(0xF80808),
+                   ColorMode::Palette16)
+            .empty());
+}
+
+TEST_CASE("mono mode drops colors but keeps attributes") {
+  CHECK(full(Style{}.fg(0x123456).bg(0x654321), ColorMode::Mono) ==
+        "\x1b[0m");
+  CHECK(transition(Style{}.fg(0x123456), Style{}.bold().fg(0x654321),
+                   ColorMode::Mono) == "\x1b[1m");
+}
+
+TEST_CASE("renderer color mode shrinks a gradient frame") {
+  constexpr core::coord_t kW = 64;
+  view::Frame frame{core::Size{kW, 1}};
+  for (core::coord_t x = 0; x < kW; ++x) {
+    const auto  t = std::uint8_t(x * 4);
+    const Style s = Style{}.fg(Style::rgb(t, 128, 255 - t));
+    frame.set(core::Point{x, 0}, core::Cell::from_char(U'#', s));
+  }
+
+  auto render_in = [&](ColorMode mode) {
+    std::ostringstream   os;
+    render::AnsiRenderer r{os, render::AnsiRendererOptions{.color_mode = mode}};
+    r.render(frame);
+    return os.str();
+  };
+
+  const std::string tc  = render_in(ColorMode::TrueColor);
+  const std::string p16 = render_in(ColorMode::Palette16);
+  CHECK(render_in(ColorMode::Palette256).size() < tc.size());
+  CHECK(p16.size() < tc.size() / 2);
+  CHECK(p16.find("38;") == std::string::npos);
+
+  // Switching modes forces a full redraw in the new depth.
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  os.str("");
+  r.set_color_mode(ColorMode::Mono);
+  r.render(frame);
+  CHECK(os.str().find(";38") == std::string::npos);
+  CHECK(os.str().find("################") != std::string::npos);
+}
+
+TEST_CASE("delta encoding cuts SGR bytes on a gradient row") {
+  // An aurora-style status row: fixed background, a foreground gradient
+  // that changes every two cells.
+  constexpr core::coord_t kW = 64;
+  const std::uint32_t     bg = 0x101828;
+
+  view::Frame frame{core::Size{kW, 1}};
+  std::vector<Style> styles;
+  for (core::coord_t x = 0; x < kW; ++x) {
+    const auto  t = std::uint8_t(x / 2 * 8);
+    const Style s = Style{}.fg(Style::rgb(t, 200, 255 - t)).bg(bg);
+    frame.set(core::Point{x, 0}, core::Cell::from_char(U'=', s));
+    styles.push_back(s);
+  }
+
+  // Bytes a "reset + set" encoder spends vs. the delta encoder.
+  std::size_t full_bytes  = 0;
+  std::size_t delta_bytes = 0;
+  Style       pen{};
+  for (std::size_t i = 0; i < styles.size(); ++i) {
+    if (i > 0 && render::same_pen(styles[i], styles[i - 1]))
+      continue;
+    full_bytes += full(styles[i]).size();
+    delta_bytes += transition(pen, styles[i]).size();
+    pen = styles[i];
+  }
+  CHECK(delta_bytes * 10 <= full_bytes * 6); // >= 40% fewer SGR bytes
+
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  const std::string out = os.str();
+
+  // The renderer emits the same minimal transitions: background once, then
+  // foreground-only updates.
+  CHECK(out.find("\x1b[38;2;8;200;247m") != std::string::npos);
+  CHECK(out.find("\x1b[0;38;2") == std::string::npos);
+  CHECK(out.size() < 64 + delta_bytes + 64); // glyphs + SGR + framing
+}
+
+TEST_CASE("SGR cache returns the encoder's bytes and counts hits") {
+  render::SgrCache cache;
+  const Style      a = Style{}.fg(0x123456).bold();
+  const Style      b = Style{}.fg(0x654321).bg(0x0000FF);
+
+  auto cached = [&](const Style &from, const Style &to) {
+    render::OutputBuffer out;
+    cache.encode_transition(out, from, to);
+    return std::string{out.view()};
+  };
+
+  CHECK(cached(a, b) == transition(a, b));
+  CHECK(cached(b, a) == transition(b, a));
+  CHECK(cached(a, b) == transition(a, b));
+  CHECK(cache.stats().hits == 1);
+  CHECK(cache.stats().misses == 2);
+
+  // Equal pens with different stored rgb share an entry.
+  Style a2 = a;
+  a2.bg_rgb = 0xABCDEF; // background stays default
+  CHECK(cached(a2, b) == transition(a, b));
+  CHECK(cache.stats().hits == 2);
+
+  // Full encodings are keyed apart from transitions.
+  render::OutputBuffer out;
+  cache.encode_full(out, b);
+  CHECK(std::string{out.view()} == full(b));
+  CHECK(cache.stats().misses == 3);
+
+  // Changing the color mode drops every entry.
+  cache.set_color_mode(ColorMode::Palette16);
+  CHECK(cached(a, b) == transition(a, b, ColorMode::Palette16));
+  CHECK(cache.stats().misses == 4);
+}
+
+TEST_CASE("SGR cache keyed on style ids matches the style-keyed bytes") {
+  render::SgrCache  cache;
+  core::StyleTable  table;
+  const Style       a  = Style{}.fg(0x123456).bold();
+  const Style       b  = Style{}.fg(0x654321).bg(0x0000FF);
+  const auto        ia = table.intern(a);
+  const auto        ib = table.intern(b);
+
+  for (int round = 0; round < 2; ++round) {
+    render::OutputBuffer out;
+    cache.encode_transition(out, ia, ib, table);
+    CHECK(std::string{out.view()} == transition(a, b));
+    out.clear();
+    cache.encode_full(out, ib, table);
+    CHECK(std::string{out.view()} == full(b));
+  }
+  CHECK(cache.stats().misses == 2);
+  CHECK(cache.stats().hits == 2);
+}
+
+TEST_CASE("SGR cache stays correct when the table overflows") {
+  render::SgrCache cache;
+  for (int round = 0; round < 2; ++round) {
+    for (std::uint32_t i = 0; i < 2 * render::SgrCache::kSlots; ++i) {
+      const Style          s = Style{}.fg(i * 0x010203u);
+      render::OutputBuffer out;
+      cache.encode_transition(out, Style{}, s);
+      REQUIRE(std::string{out.view()} == transition(Style{}, s));
+    }
+  }
+  CHECK(cache.stats().misses >= 2 * render::SgrCache::kSlots);
+}
+
+TEST_CASE("renderer hits the SGR cache on repeated style switches") {
+  view::Frame frame{core::Size{40, 1}};
+  for (core::coord_t x = 0; x < 40; ++x) {
+    const Style s = (x % 2) ? Style{}.fg(0x336699) : Style{}.fg(0x996633);
+    frame.set(core::Point{x, 0}, core::Cell::from_char(U'x', s));
+  }
+  std::ostringstream   os;
+  render::AnsiRenderer r{os};
+  r.render(frame);
+  CHECK(r.sgr_cache_stats().misses <= 3);
+  CHECK(r.sgr_cache_stats().hits >= 36);
+}
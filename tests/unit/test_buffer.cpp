@@ -4,6 +4,8 @@
 
 #include "glyph/core/buffer.h"
 
+#include <vector>
+
 using namespace glyph::core;
 
 TEST_CASE("Buffer construction and bounds") {
@@ -95,6 +97,109 @@ TEST_CASE("clear marks all lines dirty") {
   CHECK(dirty.size() == 3);
 }
 
+TEST_CASE("dirty rows keep the written column window") {
+  Buffer b{Size{300, 4}};
+  (void)b.take_dirty_lines();
+
+  b.view().put(Point{150, 1}, Cell::from_char(U'A'));
+  b.view().fill_rect(Rect{10, 2, 5, 2}, Cell::from_char(U'.'));
+  b.view().put(Point{20, 2}, Cell::from_char(U'B'));
+
+  std::vector<DirtyRow> rows;
+  (void)b.take_dirty_into(rows);
+  REQUIRE(rows.size() == 3);
+  CHECK(rows[0].y == 1);
+  CHECK(rows[0].x0 == 149); // put covers both neighbours (wide fixups)
+  CHECK(rows[0].x1 == 152);
+  CHECK(rows[1].y == 2);
+  CHECK(rows[1].x0 == 10); // union of the fill and the put
+  CHECK(rows[1].x1 == 22);
+  CHECK(rows[2].y == 3);
+  CHECK(rows[2].x0 == 10);
+  CHECK(rows[2].x1 == 15);
+
+  (void)b.take_dirty_into(rows);
+  CHECK(rows.empty());
+
+  // Whole-row marks are clipped to the buffer width.
+  b.view().clear();
+  (void)b.take_dirty_into(rows);
+  REQUIRE(rows.size() == 4);
+  CHECK(rows[0].x0 == 0);
+  CHECK(rows[0].x1 == 300);
+}
+
+TEST_CASE("writes through a subview mark the parent's rows and columns") {
+  Buffer b{Size{10, 5}};
+  (void)b.take_dirty_lines();
+
+  auto sub = b.view().subview(Rect{4, 3, 6, 2});
+  sub.put(Point{1, 0}, Cell::from_char(U'x'));
+
+  std::vector<DirtyRow> rows;
+  (void)b.take_dirty_into(rows);
+  REQUIRE(rows.size() == 1);
+  CHECK(rows[0].y == 3);
+  CHECK(rows[0].x0 == 4); // clipped to the subview, not the buffer
+  CHECK(rows[0].x1 == 7);
+}
+
+TEST_CASE("merging trackers unions their windows") {
+  DirtyLines a;
+  DirtyLines b;
+  a.resize(2);
+  b.resize(2);
+  a.clear();
+  b.clear();
+  a.mark(0, 5, 8);
+  b.mark(0, 2, 4);
+  b.mark(1, 7, 9);
+  a.merge(b);
+
+  std::vector<DirtyRow> rows;
+  (void)a.take_into(rows, 100);
+  REQUIRE(rows.size() == 2);
+  CHECK(rows[0].x0 == 2);
+  CHECK(rows[0].x1 == 8);
+  CHECK(rows[1].x0 == 7);
+  CHECK(rows[1].x1 == 9);
+}
+
+TEST_CASE("dirty set: O(1) emptiness and reusable take_into") {
+  DirtyLines d;
+  d.resize(130); // spans three words, the last one partial
+  CHECK(d.any());
+  CHECK(d.count() == 130);
+
+  std::vector<DirtyRow> rows;
+  CHECK(d.take_into(rows, 10).size() == 130);
+  CHECK_FALSE(d.any());
+  CHECK(d.take_into(rows, 10).empty());
+  CHECK(rows.empty());
+
+  d.mark(129, 2, 3);
+  d.mark(64);
+  d.mark(3, 4, 6);
+  d.mark(3, 1, 2);
+  CHECK(d.count() == 3);
+
+  const auto taken = d.take_into(rows, 10);
+  REQUIRE(taken.size() == 3);
+  CHECK(taken.data() == rows.data());
+  CHECK(taken[0].y == 3);
+  CHECK(taken[0].x0 == 1);
+  CHECK(taken[0].x1 == 6);
+  CHECK(taken[1].y == 64);
+  CHECK(taken[1].x1 == 10);
+  CHECK(taken[2].y == 129);
+  CHECK_FALSE(d.any());
+
+  // A row re-marked after a take starts a fresh window.
+  d.mark(3, 8, 9);
+  REQUIRE(d.take_into(rows, 10).size() == 1);
+  CHECK(rows[0].x0 == 8);
+}
+
 TEST_CASE("resize preserves overlapping region") {
   Buffer b{Size{2, 2}};
   b.view().put(Point{0, 0}, Cell::from_char(U'A'));
@@ -102,3 +207,71 @@ TEST_CASE("resize preserves overlapping region") {
   CHECK(b.size() == Size{4, 4});
   CHECK(b.const_view().at(0, 0).ch == U'A');
 }
+
+TEST_CASE("shift_rows moves a row block and fills the vacated rows") {
+  Buffer b{Size{2, 4}};
+  for (coord_t y = 0; y < 4; ++y)
+    b.view().put(Point{0, y}, Cell::from_char(char32_t(U'0' + y)));
+
+  b.shift_rows(1, 4, 1); // rows 1..3 scroll up by one
+  CHECK(b.const_view().at(0, 0).ch == U'0'); // outside the region
+  CHECK(b.const_view().at(0, 1).ch == U'2');
+  CHECK(b.const_view().at(0, 2).ch == U'3');
+  CHECK(b.const_view().at(0, 3) == Cell{}); // exposed row
+
+  b.shift_rows(0, 4, -2);
+  CHECK(b.const_view().at(0, 0) == Cell{});
+  CHECK(b.const_view().at(0, 1) == Cell{});
+  CHECK(b.const_view().at(0, 2).ch == U'0');
+  CHECK(b.const_view().at(0, 3).ch == U'2');
+}
+
+TEST_CASE("row_hash is cached until the row is written") {
+  Buffer b{Size{6, 3}};
+  Buffer same{Size{6, 3}};
+  const auto h0 = b.row_hash(1);
+  CHECK(h0 == hash_cells(&b.const_view().at(0, 1), 6));
+  CHECK(h0 == same.row_hash(1));
+
+  // at() bypasses dirty tracking, so the cached value is still returned.
+  b.view().at(2, 1) = Cell::from_char(U'x');
+  CHECK(b.row_hash(1) == h0);
+
+  // A tracked write invalidates just that row, even after the dirty lines
+  // were taken by someone else.
+  b.view().put(Point{2, 1}, Cell::from_char(U'y'));
+  (void)b.take_dirty_lines();
+  const auto h1 = b.row_hash(1);
+  CHECK(h1 != h0);
+  CHECK(h1 == hash_cells(&b.const_view().at(0, 1), 6));
+  CHECK(b.row_hash(0) == same.row_hash(0));
+
+  same.view().put(Point{2, 1}, Cell::from_char(U'x'));
+  same.view().put(Point{2, 1}, Cell::from_char(U'y'));
+  CHECK(same.row_hash(1) == h1);
+}
+
+TEST_CASE("clear_written rewrites only the rows written since the clear") {
+  Buffer b{Size{4, 4}};
+  const Cell dot = Cell::from_char(U'.');
+  b.clear(dot);
+  b.view().put(Point{1, 2}, Cell::from_char(U'x'));
+  // Untracked probe: a row clear_written() must leave alone.
+  b.view().at(0, 0) = Cell::from_char(U'p');
+  (void)b.take_dirty_lines();
+
+  b.clear_written(dot);
+  CHECK(b.const_view().at(1, 2) == dot);
+  CHECK(b.const_view().at(0, 0).ch == U'p');
+  CHECK(b.take_dirty_lines() == std::vector<coord_t>{2});
+
+  // Nothing written since: nothing touched.
+  b.clear_written(dot);
+  CHECK_FALSE(b.has_dirty_lines());
+
+  // A resize invalidates every row.
+  b.resize(Size{4, 5}, dot);
+  b.clear_written(dot);
+  CHECK(b.const_view().at(0, 0) == dot);
+  CHECK(b.take_dirty_lines().size() == 5);
+}
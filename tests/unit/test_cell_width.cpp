@@ -1,4 +1,4 @@
-// Unit tests for the codepoint width rule and Cell construction.
+// Unit tests for the codepoint width table and Cell construction.
 
 #include <doctest/doctest.h>
 
@@ -57,13 +57,49 @@ TEST_CASE("cell_width: emoji range boundaries") {
   CHECK(cell_width(0x1FB00) == 1); // just past emoji coverage -> narrow
 }
 
-TEST_CASE("cell_width: text-presentation symbols stay narrow (phase 1)") {
+TEST_CASE("cell_width: text-presentation symbols stay narrow") {
   // These are narrow by default and only widen with U+FE0F, which is a
-  // sequence-level concern not handled at the codepoint level yet.
+  // sequence-level concern (see cluster_width).
   CHECK(cell_width(0x2764) == 1); // heavy black heart ❤
   CHECK(cell_width(0x2600) == 1); // sun ☀
 }
 
+TEST_CASE("cell_width: emoji-presentation symbols in the BMP are wide") {
+  CHECK(cell_width(0x231A) == 2); // watch ⌚
+  CHECK(cell_width(0x26A1) == 2); // high voltage ⚡
+  CHECK(cell_width(0x2705) == 2); // check mark button ✅
+}
+
+TEST_CASE("cell_width: marks, format characters and C1 are zero-width") {
+  CHECK(cell_width(0x0301) == 0);  // combining acute accent
+  CHECK(cell_width(0x20DD) == 0);  // combining enclosing circle
+  CHECK(cell_width(0x200B) == 0);  // zero width space
+  CHECK(cell_width(0x200D) == 0);  // zero width joiner
+  CHECK(cell_width(0xFE0F) == 0);  // variation selector-16
+  CHECK(cell_width(0xFEFF) == 0);  // byte order mark
+  CHECK(cell_width(0x0085) == 0);  // NEL (C1 control)
+  CHECK(cell_width(0x1160) == 0);  // Hangul jungseong filler
+  CHECK(cell_width(0x00AD) == 1);  // soft hyphen stays visible
+}
+
+TEST_CASE("cell_width: supplementary planes") {
+  CHECK(cell_width(0x20000) == 2);  // CJK extension B
+  CHECK(cell_width(0x3134A) == 2);  // CJK extension G
+  CHECK(cell_width(0x1D400) == 1);  // mathematical bold A
+  CHECK(cell_width(0xE0001) == 0);  // language tag
+  CHECK(cell_width(0x10FFFF) == 1); // last codepoint
+  CHECK(cell_width(0x110000) == 1); // out of range
+}
+
+TEST_CASE("cell_width: ASCII fast path agrees with the table") {
+  for (char32_t c = 0; c < 0x80; ++c) {
+    const std::uint8_t expected = (c < 0x20 || c == 0x7F) ? 0 : 1;
+    CHECK(cell_width(c) == expected);
+  }
+  static_assert(cell_width(U'A') == 1 && cell_width(0x4E2D) == 2,
+                "cell_width stays usable in constant expressions");
+}
+
 TEST_CASE("Cell derives width from its codepoint") {
   Cell narrow = Cell::from_char(U'A');
   CHECK(narrow.ch == U'A');
@@ -1,9 +1,13 @@
-// Unit tests for buffer diffing (diff_lines / diff_spans / hash_line).
+// Unit tests for buffer diffing (diff_lines / diff_spans / hash_line / hash_cells).
 
 #include <doctest/doctest.h>
 
 #include "glyph/core/buffer.h"
 #include "glyph/core/diff.h"
+#include "glyph/core/row_compare.h"
+
+#include <cstdint>
+#include <vector>
 
 using namespace glyph::core;
 
@@ -65,6 +69,71 @@ TEST_CASE("diff_spans: two disjoint changes on one line yield two spans") {
   CHECK(spans[1].x1 == 6);
 }
 
+TEST_CASE("diff_spans: changes past the vector width are found") {
+  // 300 cells span many 16/32/64-byte blocks and leave an unaligned tail.
+  Buffer a = make(Size{300, 2});
+  Buffer b = make(Size{300, 2});
+  b.view().at(0, 1)   = Cell::from_char(U'a');
+  b.view().at(150, 1) = Cell::from_char(U'b');
+  b.view().at(151, 1) = Cell::from_char(U'c');
+  b.view().at(299, 1) = Cell::from_char(U'd');
+
+  const std::vector<coord_t> lines{0, 1};
+  const auto spans = diff_spans(a.const_view(), b.const_view(), lines);
+  REQUIRE(spans.size() == 3);
+  CHECK(spans[0].x0 == 0);
+  CHECK(spans[0].x1 == 1);
+  CHECK(spans[1].x0 == 150);
+  CHECK(spans[1].x1 == 152);
+  CHECK(spans[2].x0 == 299);
+  CHECK(spans[2].x1 == 300);
+}
+
+TEST_CASE("diff_spans: dirty rows limit the scan to their window") {
+  Buffer a = make(Size{300, 2});
+  Buffer b = make(Size{300, 2});
+  b.view().at(10, 0)  = Cell::from_char(U'a');
+  b.view().at(200, 0) = Cell::from_char(U'b'); // outside the window
+  b.view().at(299, 1) = Cell::from_char(U'c');
+
+  const std::vector<DirtyRow> rows{{0, 5, 50}, {1, 290, 400}};
+  std::vector<DiffSpan>       spans;
+  diff_spans(a.const_view(), b.const_view(), rows, spans);
+  REQUIRE(spans.size() == 2);
+  CHECK(spans[0].y == 0);
+  CHECK(spans[0].x0 == 10);
+  CHECK(spans[0].x1 == 11);
+  CHECK(spans[1].y == 1);
+  CHECK(spans[1].x0 == 299);
+  CHECK(spans[1].x1 == 300);
+}
+
+TEST_CASE("first_mismatch: every kernel agrees with the scalar one") {
+  constexpr std::size_t kCells = 97;
+  std::vector<Cell>     a(kCells, Cell::from_char(U'x'));
+
+  for (auto isa : {RowCompareIsa::Scalar, RowCompareIsa::Sse2,
+                   RowCompareIsa::Avx2}) {
+    if (!row_compare_supported(isa))
+      continue;
+
+    CHECK(first_mismatch(isa, a.data(), a.data(), kCells) == kCells);
+    CHECK(first_mismatch(isa, a.data(), a.data(), 0) == 0);
+
+    // A single differing byte in each field of each position.
+    for (std::size_t i = 0; i < kCells; ++i) {
+      std::vector<Cell> b = a;
+      b[i].style.bg(0x123456);
+      CHECK(first_mismatch(isa, a.data(), b.data(), kCells) == i);
+      b    = a;
+      b[i] = Cell::from_char(U'y');
+      CHECK(first_mismatch(isa, a.data(), b.data(), kCells) == i);
+      // Shorter ranges never read past their end.
+      CHECK(first_mismatch(isa, a.data(), b.data(), i) == i);
+    }
+  }
+}
+
 TEST_CASE("hash_line: equal content hashes equal, different content differs") {
   Buffer a = make(Size{4, 1});
   Buffer b = make(Size{4, 1});
@@ -73,3 +142,106 @@ TEST_CASE("hash_line: equal content hashes equal, different content differs") {
   b.view().put(Point{0, 0}, Cell::from_char(U'Z'));
   CHECK(hash_line(a.const_view(), 0) != hash_line(b.const_view(), 0));
 }
+
+TEST_CASE("hash_cells: every backend sees each byte of every cell") {
+  CHECK(hash_cells(nullptr, 0) == hash_cells(row_hash_kind(), nullptr, 0));
+
+  // Widths cover the short-input paths and the 48-byte loop with tails.
+  for (const std::size_t w : {1u, 2u, 3u, 5u, 7u, 80u}) {
+    std::vector<Cell> a(w, Cell::from_char(U'a'));
+    std::vector<Cell> b = a;
+    CHECK(hash_cells(a.data(), w) == hash_cells(row_hash_kind(), a.data(), w));
+
+    for (const RowHash kind : {RowHash::Wyhash, RowHash::Fnv1a}) {
+      CHECK(hash_cells(kind, a.data(), w) == hash_cells(kind, b.data(), w));
+      for (std::size_t x = 0; x < w; ++x) {
+        b[x].style.attrs = Style::AttrBold;
+        CHECK(hash_cells(kind, a.data(), w) != hash_cells(kind, b.data(), w));
+        b[x] = a[x];
+        b[x].ch = U'b';
+        CHECK(hash_cells(kind, a.data(), w) != hash_cells(kind, b.data(), w));
+        b[x] = a[x];
+      }
+    }
+  }
+}
+
+TEST_CASE("pad fields: ==, row compare, hash and diff agree") {
+  Buffer a = make(Size{40, 1});
+  Buffer b = make(Size{40, 1});
+  b.view().at(21, 0)._pad1 = 7;
+
+  // Cells differing only in padding are different cells everywhere.
+  CHECK(a.const_view().at(21, 0) != b.const_view().at(21, 0));
+  CHECK_FALSE(rows_equal(a.const_view(), 0, b.const_view(), 0));
+  CHECK(hash_line(a.const_view(), 0) != hash_line(b.const_view(), 0));
+
+  std::vector<DiffSpan> spans;
+  const std::vector<coord_t> lines{0};
+  diff_spans(a.const_view(), b.const_view(), lines, spans);
+  REQUIRE(spans.size() == 1);
+  CHECK(spans[0].x0 == 21);
+  CHECK(spans[0].x1 == 22);
+
+  // Equal cells are equal bytes: same hash.
+  b.view().at(21, 0) = a.const_view().at(21, 0);
+  CHECK(rows_equal(a.const_view(), 0, b.const_view(), 0));
+  CHECK(hash_line(a.const_view(), 0) == hash_line(b.const_view(), 0));
+}
+
+namespace {
+  void write_row(Buffer &b, coord_t y, char32_t tag) {
+    for (coord_t x = 0; x < b.size().w; ++x) {
+      b.view().put(Point{x, y}, Cell::from_char(x == 0 ? tag : U'-'));
+    }
+  }
+} // namespace
+
+TEST_CASE("detect_scroll: content shifted up by one line") {
+  Buffer a = make(Size{6, 8});
+  Buffer b = make(Size{6, 8});
+  for (coord_t y = 0; y < 8; ++y) {
+    write_row(a, y, char32_t(U'a' + y));
+    write_row(b, y, char32_t(U'a' + y + 1)); // row y shows old row y + 1
+  }
+
+  const auto ha   = line_hashes(a.const_view());
+  const auto hb   = line_hashes(b.const_view());
+  const auto hint = detect_scroll(a.const_view(), b.const_view(), ha, hb);
+  REQUIRE_FALSE(hint.empty());
+  CHECK(hint.shift == 1);
+  CHECK(hint.top == 0);
+  CHECK(hint.bottom == 8);
+}
+
+TEST_CASE("detect_scroll: shift inside a pane below a static header") {
+  Buffer a = make(Size{6, 8});
+  Buffer b = make(Size{6, 8});
+  write_row(a, 0, U'H');
+  write_row(b, 0, U'H');
+  for (coord_t y = 1; y < 8; ++y) {
+    write_row(a, y, char32_t(U'a' + y));
+    write_row(b, y, char32_t(U'a' + y - 2)); // scrolled down by two
+  }
+
+  const auto hint = detect_scroll(a.const_view(), b.const_view(),
+                                  line_hashes(a.const_view()),
+                                  line_hashes(b.const_view()));
+  REQUIRE_FALSE(hint.empty());
+  CHECK(hint.shift == -2);
+  CHECK(hint.top == 1);
+  CHECK(hint.bottom == 8);
+}
+
+TEST_CASE("detect_scroll: unrelated changes produce no hint") {
+  Buffer a = make(Size{4, 6});
+  Buffer b = make(Size{4, 6});
+  for (coord_t y = 0; y < 6; ++y) {
+    write_row(a, y, char32_t(U'a' + y));
+    write_row(b, y, char32_t(U'A' + y));
+  }
+  const auto hint = detect_scroll(a.const_view(), b.const_view(),
+                                  line_hashes(a.const_view()),
+                                  line_hashes(b.const_view()));
+  CHECK(hint.empty());
+}
@@ -0,0 +1,76 @@
+// Unit tests for FramePacer scheduling.
+//
+// Uses explicit time points so the coalescing rules are checked without
+// depending on wall-clock timing.
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "glyph/render/frame_pacer.h"
+
+using namespace glyph::render;
+using namespace std::chrono_literals;
+
+namespace {
+  const FramePacer::time_point t0 = FramePacer::clock::now();
+} // namespace
+
+TEST_CASE("nothing is due until something is invalidated") {
+  FramePacer pacer;
+  CHECK_FALSE(pacer.pending());
+  CHECK_FALSE(pacer.frame_due(t0 + 1s));
+  CHECK(pacer.deadline() == FramePacer::time_point::max());
+}
+
+TEST_CASE("invalidations inside one interval coalesce into one frame") {
+  FramePacer pacer{{.max_fps = 50}}; // 20ms interval
+  pacer.invalidate(t0);
+  CHECK(pacer.frame_due(t0));
+  pacer.begin_frame(t0);
+
+  // A burst of model updates right after the frame.
+  for (int i = 1; i <= 10; ++i) {
+    pacer.invalidate(t0 + std::chrono::milliseconds(i));
+  }
+  CHECK(pacer.pending());
+  CHECK_FALSE(pacer.frame_due(t0 + 19ms));
+  CHECK(pacer.frame_due(t0 + 20ms));
+  pacer.begin_frame(t0 + 20ms);
+
+  CHECK(pacer.frames() == 2);
+  CHECK(pacer.coalesced() == 9);
+  CHECK_FALSE(pacer.pending());
+}
+
+TEST_CASE("input requests wait out the input latency") {
+  FramePacer pacer{{.max_fps = 0, .input_latency = 3ms}};
+  pacer.request_frame(t0);
+  CHECK_FALSE(pacer.frame_due(t0 + 2ms));
+  CHECK(pacer.frame_due(t0 + 3ms));
+
+  // A model update does not wait behind pending input.
+  FramePacer both{{.max_fps = 0, .input_latency = 3ms}};
+  both.request_frame(t0);
+  both.invalidate(t0 + 1ms);
+  CHECK(both.frame_due(t0 + 1ms));
+}
+
+TEST_CASE("wait returns when another thread invalidates") {
+  FramePacer  pacer{{.max_fps = 0}};
+  std::thread t{[&] {
+    std::this_thread::sleep_for(5ms);
+    pacer.invalidate();
+  }};
+  CHECK(pacer.wait(10s));
+  t.join();
+  CHECK(pacer.frame_due());
+}
+
+TEST_CASE("wait times out while idle") {
+  FramePacer pacer;
+  const auto start = FramePacer::clock::now();
+  CHECK_FALSE(pacer.wait(5ms));
+  CHECK(FramePacer::clock::now() - start >= 5ms);
+}
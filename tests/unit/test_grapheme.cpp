@@ -0,0 +1,162 @@
+// Unit tests for grapheme segmentation, cluster widths and ClusterPool.
+
+#include <doctest/doctest.h>
+
+#include <string>
+#include <string_view>
+
+#include "glyph/core/buffer.h"
+#include "glyph/core/cluster.h"
+#include "glyph/core/text.h"
+#include "glyph/view/frame.h"
+#include "glyph/view/text.h"
+
+using namespace glyph::core;
+
+namespace {
+  // Cluster lengths (in codepoints) of `s`.
+  std::u32string segment(std::u32string_view s) {
+    std::u32string out;
+    for (std::size_t i = 0; i < s.size();) {
+      const std::size_t end = next_grapheme(s, i);
+      out.push_back(char32_t(end - i));
+      i = end;
+    }
+    return out;
+  }
+
+  // 👩‍💻 woman technologist; 🇯🇵 flag; 👍🏽 thumbs up, medium skin tone.
+  constexpr std::u32string_view kTechnologist = U"\U0001F469\u200D\U0001F4BB";
+  constexpr std::u32string_view kFlag         = U"\U0001F1EF\U0001F1F5";
+  constexpr std::u32string_view kThumbs       = U"\U0001F44D\U0001F3FD";
+} // namespace
+
+TEST_CASE("next_grapheme: plain text is one codepoint per cluster") {
+  CHECK(segment(U"abc") == std::u32string{1, 1, 1});
+  CHECK(segment(U"中a") == std::u32string{1, 1});
+  CHECK(segment(U"") == std::u32string{});
+}
+
+TEST_CASE("next_grapheme: combining marks, ZWJ, flags, modifiers") {
+  CHECK(segment(U"e\u0301x") == std::u32string{2, 1});
+  CHECK(segment(kTechnologist) == std::u32string{3});
+  CHECK(segment(std::u32string{kFlag} + std::u32string{kFlag}) ==
+        std::u32string{2, 2});
+  CHECK(segment(kThumbs) == std::u32string{2});
+  CHECK(segment(U"\u2764\uFE0F!") == std::u32string{2, 1});
+  CHECK(segment(U"\r\n") == std::u32string{2});
+  // A ZWJ followed by a non-pictograph does not join it.
+  CHECK(segment(U"a\u200Db") == std::u32string{2, 1});
+}
+
+TEST_CASE("cluster_width: emoji sequences are wide, marks keep the base") {
+  CHECK(cluster_width(U"e\u0301") == 1);
+  CHECK(cluster_width(kTechnologist) == 2);
+  CHECK(cluster_width(kFlag) == 2);
+  CHECK(cluster_width(kThumbs) == 2);
+  CHECK(cluster_width(U"\u2764") == 1);
+  CHECK(cluster_width(U"\u2764\uFE0F") == 2);
+  CHECK(cluster_width(U"") == 0);
+}
+
+TEST_CASE("ClusterPool: single codepoints stay inline") {
+  ClusterPool pool;
+  CHECK(pool.intern(U"a") == U'a');
+  CHECK(pool.intern(U"中") == U'中');
+  CHECK(pool.empty());
+}
+
+TEST_CASE("ClusterPool: clusters are stored once as UTF-8") {
+  ClusterPool pool;
+  const char32_t t = pool.intern(kTechnologist);
+  CHECK(is_cluster(t));
+  CHECK(pool.intern(kTechnologist) == t);
+  CHECK(pool.size() == 1);
+  CHECK(pool.utf8(t) == "\xF0\x9F\x91\xA9\xE2\x80\x8D\xF0\x9F\x92\xBB");
+  CHECK(pool.width(t) == 2);
+
+  const char32_t e = pool.intern(U"e\u0301");
+  CHECK(e != t);
+  CHECK(pool.utf8(e) == "e\xCC\x81");
+  CHECK(pool.width(e) == 1);
+
+  pool.clear();
+  CHECK(pool.empty());
+  CHECK(pool.utf8(t).empty());
+}
+
+TEST_CASE("ClusterPool: equal clusters get equal tags in separate pools") {
+  ClusterPool a;
+  ClusterPool b;
+  (void)b.intern(kFlag);
+  CHECK(a.intern(kTechnologist) == b.intern(kTechnologist));
+  CHECK(b.import(a, a.intern(kThumbs)) == a.intern(kThumbs));
+  CHECK(b.utf8(a.intern(kThumbs)) == a.utf8(a.intern(kThumbs)));
+}
+
+TEST_CASE("ClusterPool: adopt keeps tags and reports a reused one") {
+  // Two clusters whose 31-bit tags collide.
+  constexpr std::u32string_view kOne = U"b\u033F\u0323";
+  constexpr std::u32string_view kTwo = U"b\u036C\u0369";
+
+  ClusterPool frame1;
+  ClusterPool frame2;
+  const char32_t t = frame1.intern(kOne);
+  REQUIRE(frame2.intern(kTwo) == t);
+
+  ClusterPool shadow;
+  CHECK(shadow.adopt_all(frame1));
+  CHECK(shadow.utf8(t) == frame1.utf8(t));
+  CHECK(shadow.adopt_all(frame1)); // same bytes again: fine
+  CHECK(shadow.adopt(frame1, U'x'));
+
+  // The same tag naming other bytes is refused, and nothing changes.
+  CHECK_FALSE(shadow.adopt_all(frame2));
+  CHECK(shadow.utf8(t) == frame1.utf8(t));
+  CHECK(shadow.size() == 1);
+}
+
+TEST_CASE("ClusterPool: survives growth past its first table") {
+  ClusterPool    pool;
+  std::u32string s = U"a\u0301";
+  for (char32_t base = U'a'; base < U'a' + 200; ++base) {
+    s[0] = base;
+    (void)pool.intern(s);
+  }
+  CHECK(pool.size() == 200);
+  s[0] = U'd';
+  const char32_t t = pool.intern(s);
+  CHECK(pool.size() == 200);
+  CHECK(pool.utf8(t).size() == 3);
+}
+
+TEST_CASE("Buffer: blit re-interns clusters into the target pool") {
+  Buffer src{Size{4, 1}};
+  Buffer dst{Size{4, 1}};
+  Cell   c{};
+  c.ch    = src.clusters().intern(kFlag);
+  c.width = 2;
+  src.view().put(Point{0, 0}, c);
+
+  dst.blit(src.const_view(), Point{1, 0});
+  const char32_t t = dst.const_view().at(1, 0).ch;
+  CHECK(is_cluster(t));
+  CHECK(dst.clusters().utf8(t) == src.clusters().utf8(c.ch));
+
+  // Clearing releases the clusters along with the cells.
+  dst.clear();
+  CHECK(dst.clusters().empty());
+}
+
+TEST_CASE("draw_text: places one grapheme cluster per cell") {
+  glyph::view::Frame f{Size{8, 1}};
+  glyph::view::draw_text(f, Point{0, 0},
+                         std::u32string{U"e\u0301"} +
+                             std::u32string{kTechnologist} + U"x");
+  CHECK(is_cluster(f.at(0, 0).ch));
+  CHECK(f.at(0, 0).width == 1);
+  CHECK(is_cluster(f.at(1, 0).ch));
+  CHECK(f.at(1, 0).width == 2);
+  CHECK(f.at(2, 0).width == 0);
+  CHECK(f.at(3, 0).ch == U'x');
+}
@@ -0,0 +1,150 @@
+// Unit tests for the renderer byte arena and output sinks.
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "glyph/render/output.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace glyph::render;
+
+TEST_CASE("OutputBuffer formats integers without iostreams") {
+  OutputBuffer b;
+  b.append_uint(0);
+  b.append(';');
+  b.append_uint(7);
+  b.append(';');
+  b.append_uint(255);
+  b.append(';');
+  b.append_uint(4294967295u);
+  CHECK(b.view() == "0;7;255;4294967295");
+}
+
+TEST_CASE("OutputBuffer encodes UTF-8") {
+  OutputBuffer b;
+  b.append_utf8(U'a');
+  b.append_utf8(U'é');
+  b.append_utf8(U'中');
+  b.append_utf8(U'\U0001F600');
+  CHECK(b.view() == "a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+}
+
+TEST_CASE("OutputBuffer keeps its capacity across clear()") {
+  OutputBuffer b;
+  b.append(std::string(10000, 'x'));
+  const auto cap  = b.capacity();
+  const auto *ptr = b.data();
+  CHECK(cap >= 10000);
+
+  b.clear();
+  CHECK(b.empty());
+  b.append(std::string(9000, 'y'));
+  CHECK(b.capacity() == cap);
+  CHECK(b.data() == ptr); // no reallocation in steady state
+}
+
+TEST_CASE("OstreamSink forwards bytes and gathered parts") {
+  std::ostringstream os;
+  OstreamSink        sink{os};
+  sink.write("ab");
+  const std::string_view parts[] = {"c", "", "de"};
+  sink.write_parts(parts);
+  CHECK(os.str() == "abcde");
+}
+
+#if !defined(_WIN32)
+TEST_CASE("FdSink writes gathered parts to a descriptor") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+
+  FdSink                 sink{fds[1]};
+  const std::string_view parts[] = {"\x1b[H", "body", "\x1b[0m"};
+  sink.write_parts(parts);
+  ::close(fds[1]);
+
+  std::string got;
+  char        tmp[64];
+  for (;;) {
+    const auto n = ::read(fds[0], tmp, sizeof(tmp));
+    if (n <= 0)
+      break;
+    got.append(tmp, std::size_t(n));
+  }
+  ::close(fds[0]);
+
+  CHECK(got == "\x1b[Hbody\x1b[0m");
+}
+
+TEST_CASE("NonBlockingFdSink queues what a full pipe cannot take") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+
+  // Far more than any pipe buffer holds; a blocking write would hang here.
+  std::string payload;
+  for (int i = 0; payload.size() < (1u << 20); ++i) {
+    payload += std::to_string(i);
+    payload += ';';
+  }
+
+  std::string got;
+  {
+    NonBlockingFdSink sink{fds[1]};
+    sink.write(payload);
+    CHECK(sink.bytes_outstanding() > 0);
+    CHECK(sink.bytes_outstanding() < payload.size());
+    sink.write("|tail");
+
+    // Read everything while draining; bytes arrive complete and in order.
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    char tmp[4096];
+    while (got.size() < payload.size() + 5) {
+      const auto n = ::read(fds[0], tmp, sizeof(tmp));
+      if (n > 0) {
+        got.append(tmp, std::size_t(n));
+      }
+      sink.flush();
+    }
+    CHECK(sink.bytes_outstanding() == 0);
+  }
+  CHECK(got == payload + "|tail");
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("NonBlockingFdSink drops its queue on a hard write error") {
+  // Report EPIPE instead of dying on SIGPIPE.
+  const auto old_handler = std::signal(SIGPIPE, SIG_IGN);
+
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  {
+    NonBlockingFdSink sink{fds[1]};
+    sink.write(std::string(1u << 20, 'x'));
+    REQUIRE(sink.bytes_outstanding() > 0);
+    CHECK(sink.error() == 0);
+
+    // The reader goes away: what is queued can never be delivered.
+    ::close(fds[0]);
+    sink.flush();
+    CHECK(sink.bytes_outstanding() == 0);
+    CHECK(sink.error() == EPIPE);
+
+    // Later writes fail the same way instead of queueing.
+    sink.write("more");
+    CHECK(sink.bytes_outstanding() == 0);
+  }
+  ::close(fds[1]);
+
+  std::signal(SIGPIPE, old_handler);
+}
+#endif
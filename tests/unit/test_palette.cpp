@@ -0,0 +1,60 @@
+// Unit tests for palette quantization tables.
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+
+#include "glyph/render/ansi/palette.h"
+
+using namespace glyph::render;
+
+namespace {
+  std::uint32_t xterm_rgb(int idx) {
+    if (idx < 16)
+      return kAnsiBasePalette[idx];
+    if (idx >= 232) {
+      const std::uint32_t v = std::uint32_t(8 + 10 * (idx - 232));
+      return (v << 16) | (v << 8) | v;
+    }
+    constexpr std::uint32_t kLevels[6] = {0, 95, 135, 175, 215, 255};
+    const int i = idx - 16;
+    return (kLevels[i / 36] << 16) | (kLevels[i / 6 % 6] << 8) |
+           kLevels[i % 6];
+  }
+} // namespace
+
+TEST_CASE("every xterm palette color maps back to itself") {
+  for (int idx = 0; idx < 256; ++idx) {
+    const std::uint32_t rgb = xterm_rgb(idx);
+    const int           e   = exact_palette_index(rgb);
+    REQUIRE(e >= 0);
+    CHECK(xterm_rgb(e) == rgb);
+    if (idx >= 16 && e >= 16) {
+      CHECK(nearest_palette_256(rgb) == e);
+    }
+  }
+  for (int idx = 0; idx < 16; ++idx) {
+    CHECK(nearest_palette_16(kAnsiBasePalette[idx]) == idx);
+  }
+}
+
+TEST_CASE("base colors win over identical cube entries") {
+  CHECK(exact_palette_index(0x000000) == 0);
+  CHECK(exact_palette_index(0xFF0000) == 9);
+  CHECK(exact_palette_index(0xFFFFFF) == 15);
+  CHECK(exact_palette_index(0x5F0000) == 52);
+  CHECK(exact_palette_index(0x123457) == -1);
+}
+
+TEST_CASE("256-color quantization picks cube or gray ramp") {
+  CHECK(nearest_palette_256(0xFE0101) == 196);
+  CHECK(nearest_palette_256(0x7F7F7F) == 244); // gray 0x80
+  CHECK(nearest_palette_256(0x0000F0) == 21);
+}
+
+TEST_CASE("16-color quantization picks the nearest base color") {
+  CHECK(nearest_palette_16(0xF01010) == 9);
+  CHECK(nearest_palette_16(0x700000) == 1);
+  CHECK(nearest_palette_16(0x0C0C0C) == 0);
+  CHECK(nearest_palette_16(0xB0B0B0) == 7);
+}
@@ -0,0 +1,97 @@
+// Unit tests for PlanarBuffer (SoA cell storage).
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "glyph/core/buffer.h"
+#include "glyph/core/diff.h"
+#include "glyph/core/planar_buffer.h"
+
+using namespace glyph::core;
+
+TEST_CASE("planar rows are cache-line aligned in every plane") {
+  PlanarBuffer b{Size{70, 3}};
+  CHECK(b.stride() % 64 == 0);
+  for (coord_t y = 0; y < 3; ++y) {
+    CHECK(reinterpret_cast<std::uintptr_t>(b.glyph_row(y)) % 64 == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(b.width_row(y)) % 64 == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(b.style_row(y)) % 64 == 0);
+  }
+}
+
+TEST_CASE("planar buffer round-trips through the AoS layout") {
+  Buffer aos{Size{5, 2}};
+  aos.view().put(Point{0, 0}, Cell::from_char(U'a', Style::with_fg(0x112233)));
+  aos.view().put(Point{1, 1}, Cell::from_char(U'中'));
+
+  PlanarBuffer planar{Size{5, 2}};
+  planar.blit(aos.const_view(), Point{0, 0});
+  CHECK(planar.get(0, 0) == aos.const_view().at(0, 0));
+  CHECK(planar.get(1, 1).width == 2);
+  CHECK(planar.get(2, 1).width == 0);
+
+  Buffer back{Size{5, 2}};
+  planar.copy_to(back.view());
+  for (coord_t y = 0; y < 2; ++y) {
+    for (coord_t x = 0; x < 5; ++x) {
+      CHECK(back.const_view().at(x, y) == aos.const_view().at(x, y));
+    }
+  }
+}
+
+TEST_CASE("fill_style restyles without touching glyphs") {
+  PlanarBuffer b{Size{6, 2}, Cell::from_char(U'x')};
+  (void)b.take_dirty_lines();
+  b.fill_style(Rect{2, 1, 10, 5}, Style::with_bg(0x0000FF));
+
+  CHECK(b.get(1, 1).style == Style{});
+  CHECK(b.get(2, 1).style == Style::with_bg(0x0000FF));
+  CHECK(b.get(5, 1).ch == U'x');
+  CHECK(b.take_dirty_lines() == std::vector<coord_t>{1});
+}
+
+TEST_CASE("planar diff_spans matches the AoS diff") {
+  const Size   size{150, 3};
+  PlanarBuffer prev{size};
+  PlanarBuffer next{size};
+  Buffer       aprev{size};
+  Buffer       anext{size};
+
+  auto set_both = [&](Point p, Cell c) {
+    next.set(p, c);
+    anext.view().at(p.x, p.y) = c;
+  };
+  set_both(Point{0, 0}, Cell::from_char(U'a'));
+  set_both(Point{70, 1}, Cell::from_char(U' ', Style::with_bg(0x102030)));
+  set_both(Point{71, 1}, Cell::from_char(U'b'));
+  set_both(Point{149, 2}, Cell::from_char(U'c'));
+  // Style-only and width-only changes are found too.
+  set_both(Point{100, 2}, Cell::from_char(U' ', Style{}.bold()));
+  Cell narrow = Cell::from_char(U' ');
+  narrow.width = 0;
+  set_both(Point{120, 2}, narrow);
+
+  const std::vector<coord_t> lines{0, 1, 2};
+  std::vector<DiffSpan>      planar_spans;
+  diff_spans(prev, next, lines, planar_spans);
+  const auto aos_spans = diff_spans(aprev.const_view(), anext.const_view(),
+                                    std::span<const coord_t>(lines));
+
+  REQUIRE(planar_spans.size() == aos_spans.size());
+  for (std::size_t i = 0; i < aos_spans.size(); ++i) {
+    CHECK(planar_spans[i].y == aos_spans[i].y);
+    CHECK(planar_spans[i].x0 == aos_spans[i].x0);
+    CHECK(planar_spans[i].x1 == aos_spans[i].x1);
+  }
+}
+
+TEST_CASE("planar resize keeps the overlap") {
+  PlanarBuffer b{Size{4, 2}};
+  b.set(Point{1, 1}, Cell::from_char(U'q'));
+  b.resize(Size{100, 3}, Cell::from_char(U'.'));
+  CHECK(b.size() == Size{100, 3});
+  CHECK(b.get(1, 1).ch == U'q');
+  CHECK(b.get(50, 2).ch == U'.');
+}
@@ -0,0 +1,66 @@
+// Unit tests for RenderStats aggregation.
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+
+#include "glyph/render/render_stats.h"
+
+using namespace glyph::render;
+
+namespace {
+  RenderStats with_bytes(std::uint64_t bytes) {
+    RenderStats s{};
+    s.bytes = bytes;
+    return s;
+  }
+} // namespace
+
+TEST_CASE("an empty window summarizes to zeros") {
+  RenderStatsWindow w{8};
+  const auto        s = w.summarize(RenderMetric::Bytes);
+  CHECK(s.p50 == 0);
+  CHECK(s.p99 == 0);
+  CHECK(s.max == 0);
+}
+
+TEST_CASE("percentiles use nearest rank over the window") {
+  RenderStatsWindow w{100};
+  // Push 1..100 out of order.
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    w.push(with_bytes((i * 37) % 100 + 1));
+  }
+  const auto s = w.summarize(RenderMetric::Bytes);
+  CHECK(s.p50 == 50);
+  CHECK(s.p99 == 99);
+  CHECK(s.max == 100);
+}
+
+TEST_CASE("the window only keeps the most recent frames") {
+  RenderStatsWindow w{4};
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    w.push(with_bytes(1000));
+  }
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    w.push(with_bytes(10));
+  }
+  CHECK(w.size() == 4);
+  CHECK(w.total_frames() == 8);
+  CHECK(w.summarize(RenderMetric::Bytes).max == 10);
+
+  w.clear();
+  CHECK(w.size() == 0);
+  CHECK(w.total_frames() == 0);
+}
+
+TEST_CASE("total time sums the stages") {
+  RenderStats s{};
+  s.dirty_ns  = 1;
+  s.hash_ns   = 2;
+  s.diff_ns   = 3;
+  s.encode_ns = 4;
+  s.write_ns  = 5;
+  CHECK(s.total_ns() == 15);
+  CHECK(metric_value(s, RenderMetric::TotalNs) == 15);
+  CHECK(metric_value(s, RenderMetric::DiffNs) == 3);
+}
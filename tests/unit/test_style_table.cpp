@@ -0,0 +1,46 @@
+// Unit tests for style interning.
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "glyph/core/style_table.h"
+
+using namespace glyph::core;
+
+TEST_CASE("style table interns equal styles to one id") {
+  StyleTable t;
+  CHECK(t.intern(Style{}) == StyleTable::kDefault);
+
+  const auto a = t.intern(Style{}.fg(0x112233).bold());
+  const auto b = t.intern(Style{}.fg(0x112233));
+  CHECK(a != b);
+  CHECK(t.intern(Style{}.fg(0x112233).bold()) == a);
+  CHECK(t.style(a) == Style{}.fg(0x112233).bold());
+  CHECK(t.size() == 3);
+
+  // Growth keeps every id.
+  std::vector<style_id_t> ids;
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    ids.push_back(t.intern(Style::with_bg(i)));
+  }
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    CHECK(t.style(ids[i]) == Style::with_bg(i));
+  }
+  CHECK(t.intern(Style{}.fg(0x112233)) == b);
+
+  t.clear();
+  CHECK(t.size() == 1);
+  CHECK(t.intern(Style{}) == StyleTable::kDefault);
+}
+
+TEST_CASE("style table reports kFull when ids run out") {
+  StyleTable t;
+  for (std::uint32_t i = 1; i < StyleTable::kFull; ++i) {
+    REQUIRE(t.intern(Style::with_fg(i)) != StyleTable::kFull);
+  }
+  CHECK(t.intern(Style::with_fg(0xABCDEF)) == StyleTable::kFull);
+  // Known styles still resolve.
+  CHECK(t.intern(Style::with_fg(7)) != StyleTable::kFull);
+}
@@ -129,3 +129,26 @@ TEST_CASE("bracketed paste produces a PasteEvent") {
   REQUIRE(std::holds_alternative<PasteEvent>(ev[0]));
   CHECK(std::get<PasteEvent>(ev[0]).text == U"hello");
 }
+
+TEST_CASE("DECRPM replies produce a ModeReportEvent") {
+  auto ev = decode(U"\x1b[?2026;2$y");
+  REQUIRE(ev.size() == 1);
+  REQUIRE(std::holds_alternative<ModeReportEvent>(ev[0]));
+  const auto &r = std::get<ModeReportEvent>(ev[0]);
+  CHECK(r.mode == 2026);
+  CHECK(r.state == ModeState::Reset);
+  CHECK(r.dec_private);
+  CHECK(r.supported());
+
+  auto unknown = decode(U"\x1b[?2026;0$y");
+  REQUIRE(unknown.size() == 1);
+  CHECK_FALSE(std::get<ModeReportEvent>(unknown[0]).supported());
+}
+
+TEST_CASE("malformed or unhandled replies are swallowed") {
+  // Neither leaks into the key stream; keys around them still decode.
+  auto ev = decode(U"a\x1b[?2026$y\x1b[?1;2cb");
+  REQUIRE(ev.size() == 2);
+  CHECK(as_key(ev[0]).ch == U'a');
+  CHECK(as_key(ev[1]).ch == U'b');
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# tools/gen_width_data.py
+#
+# Regenerates include/glyph/core/detail/width_data.h: the two-stage lookup
+# table behind core::cell_width(), derived from the Unicode Character
+# Database bundled with this Python (unicodedata.unidata_version). Rerun it
+# with a newer Python to pick up a newer Unicode version.
+#
+# Rules, in order:
+#   0: C0/C1 controls and DEL, nonspacing/enclosing marks (Mn, Me), format
+#      characters (Cf) except SOFT HYPHEN, Hangul medial vowels and final
+#      consonants (U+1160..U+11FF).
+#   2: East Asian Width W or F (this includes every Emoji_Presentation
+#      codepoint), regional indicators, and unassigned codepoints in the
+#      pictograph blocks (U+1F000..U+1FAFF) and CJK planes 2 and 3, so new
+#      emoji and ideographs come out wide before the table catches up.
+#   1: everything else.
+#
+# Usage: python3 tools/gen_width_data.py > include/glyph/core/detail/width_data.h
+
+import sys
+import unicodedata
+
+BLOCK_COUNT = 0x110000 >> 8
+BLOCK_BYTES = 256 // 4
+
+
+def width(cp):
+    if cp < 0x20 or cp == 0x7F or 0x80 <= cp < 0xA0:
+        return 0
+    ch = chr(cp)
+    cat = unicodedata.category(ch)
+    if cat in ("Mn", "Me") or (cat == "Cf" and cp != 0xAD):
+        return 0
+    if 0x1160 <= cp <= 0x11FF:
+        return 0
+    if cat == "Cn":
+        # unicodedata reports no meaningful East Asian Width here.
+        return 2 if 0x1F000 <= cp <= 0x1FAFF or 0x20000 <= cp <= 0x3FFFD else 1
+    if unicodedata.east_asian_width(ch) in ("W", "F"):
+        return 2
+    if 0x1F1E6 <= cp <= 0x1F1FF:
+        return 2
+    return 1
+
+
+def tables():
+    index, blocks, seen = [], [], {}
+    for b in range(BLOCK_COUNT):
+        packed = bytearray(BLOCK_BYTES)
+        for i in range(256):
+            packed[i >> 2] |= width((b << 8) | i) << ((i & 3) * 2)
+        key = bytes(packed)
+        if key not in seen:
+            seen[key] = len(blocks)
+            blocks.append(key)
+        index.append(seen[key])
+    assert len(blocks) <= 256, "stage-1 entries are one byte"
+    return index, blocks
+
+
+def emit_bytes(w, data, indent):
+    for i in range(0, len(data), 16):
+        w(indent + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+
+
+def main():
+    index, blocks = tables()
+    w = sys.stdout.write
+    w("// glyph/core/detail/width_data.h\n")
+    w("//\n")
+    w("// GENERATED by tools/gen_width_data.py from Unicode %s. Do not edit.\n"
+      % unicodedata.unidata_version)
+    w("//\n")
+    w("// Two-stage cell width table for core::cell_width(): kWidthIndex maps\n")
+    w("// each 256-codepoint block to a row of kWidthBlocks, which holds 2 bits\n")
+    w("// per codepoint (lowest bits first). Identical blocks share a row.\n")
+    w("\n#pragma once\n\n#include <cstddef>\n#include <cstdint>\n\n")
+    w("namespace glyph::core::detail {\n\n")
+    w("  inline constexpr char kWidthDataVersion[] = \"%s\";\n\n"
+      % unicodedata.unidata_version)
+    w("  inline constexpr std::size_t kWidthBlockCount = %d;\n" % BLOCK_COUNT)
+    w("  inline constexpr std::size_t kWidthBlockBytes = %d;\n\n" % BLOCK_BYTES)
+    w("  // clang-format off\n")
+    w("  inline constexpr std::uint8_t kWidthIndex[kWidthBlockCount] = {\n")
+    emit_bytes(w, index, "    ")
+    w("  };\n\n")
+    w("  inline constexpr std::uint8_t kWidthBlocks[%d][kWidthBlockBytes] = {\n"
+      % len(blocks))
+    for blk in blocks:
+        w("    {\n")
+        emit_bytes(w, blk, "      ")
+        w("    },\n")
+    w("  };\n")
+    w("  // clang-format on\n\n")
+    w("} // namespace glyph::core::detail\n")
+
+
+if __name__ == "__main__":
+    main()